@@ -55,7 +55,86 @@
  * 定义此宏以启用或禁用锁功能。
  * 设置为0以禁用锁，设置为1以启用锁。
  * 锁功能用于保护共享资源，避免多线程或多任务环境中的数据竞争问题。
+ * 禁用锁时进入单生产者单消费者无锁模式，读写索引通过C11原子操作的
+ * acquire/release语义交接，在x86、ARM、RISC-V等弱内存序平台上同样安全。
+ * 可在编译命令中通过-DENABLE_LOCK=0覆盖默认值。
  */
+#ifndef ENABLE_LOCK
 #define ENABLE_LOCK 1
+#endif
+
+/**
+ * @def CIRCULAR_BUFFER_SEPARATE_INDEX
+ * @brief 生产者与消费者索引分离布局开关
+ *
+ * 设置为1时，环形缓冲区结构体中生产者拥有的状态（end及其缓存的start）与
+ * 消费者拥有的状态（start及其缓存的end）分别放置在独立的缓存行上，
+ * 每一方只在本地缓存视图显示缓冲区已满或已空时才读取对方的索引，
+ * 避免跨核单生产者单消费者场景下的缓存行乒乓。
+ * 设置为0时使用紧凑布局，适合内存受限的单核嵌入式平台。
+ */
+#ifndef CIRCULAR_BUFFER_SEPARATE_INDEX
+#if defined(PLATFORM_LINUX)
+#define CIRCULAR_BUFFER_SEPARATE_INDEX 1
+#else
+#define CIRCULAR_BUFFER_SEPARATE_INDEX 0
+#endif
+#endif
+
+/**
+ * @def CIRCULAR_BUFFER_CACHE_LINE_SIZE
+ * @brief 缓存行大小（字节）
+ *
+ * 索引分离布局下用于对齐生产者区和消费者区。
+ */
+#ifndef CIRCULAR_BUFFER_CACHE_LINE_SIZE
+#define CIRCULAR_BUFFER_CACHE_LINE_SIZE 64
+#endif
+
+/**
+ * @def CIRCULAR_BUFFER_SPIN_COUNT
+ * @brief 无锁模式下等待接口休眠前的自旋次数
+ *
+ * 关闭锁时，circular_buffer_read_timed/circular_buffer_write_timed先自旋重试
+ * 指定次数，仍不满足条件时才在futex上休眠，兼顾短等待的延迟和长等待的CPU占用。
+ */
+#ifndef CIRCULAR_BUFFER_SPIN_COUNT
+#define CIRCULAR_BUFFER_SPIN_COUNT 1000
+#endif
+
+/**
+ * @def CIRCULAR_BUFFER_SPLIT_LOCK
+ * @brief 读写分离锁开关
+ *
+ * 设置为1时，启用锁的环形缓冲区使用两把互斥锁：生产者锁串行化写入端对end的更新，
+ * 消费者锁串行化读取端对start的更新，对方的索引通过原子操作读取，
+ * 读写两侧不再争抢同一把锁。设置为0时读写共用一把锁。
+ * 仅在ENABLE_LOCK为1时生效，可在编译命令中通过-DCIRCULAR_BUFFER_SPLIT_LOCK=1覆盖默认值。
+ */
+#ifndef CIRCULAR_BUFFER_SPLIT_LOCK
+#define CIRCULAR_BUFFER_SPLIT_LOCK 0
+#endif
+
+/**
+ * @def CIRCULAR_BUFFER_HUGE_PAGE_SIZE
+ * @brief 大页大小（字节）
+ *
+ * 申请大页内存时，显式大页要求缓冲区大小为该值的整数倍，
+ * 透明大页按该值对齐映射起始地址。x86-64和ARM64默认的大页均为2MiB。
+ */
+#ifndef CIRCULAR_BUFFER_HUGE_PAGE_SIZE
+#define CIRCULAR_BUFFER_HUGE_PAGE_SIZE (2u * 1024u * 1024u)
+#endif
+
+/**
+ * @def CIRCULAR_BUFFER_SPLICER_MAX_SENDS
+ * @brief 发送器以MSG_ZEROCOPY发送到套接字时，最多同时等待完成通知的发送次数
+ *
+ * 每次发送的字节数记录在发送器中，内核的完成通知到达之前这些页面不能归还给写入端；
+ * 记录已满时发送返回EAGAIN，等待完成通知后重试。
+ */
+#ifndef CIRCULAR_BUFFER_SPLICER_MAX_SENDS
+#define CIRCULAR_BUFFER_SPLICER_MAX_SENDS 64
+#endif
 
 #endif // CONFIG_H
@@ -1,6 +1,8 @@
 // port.c
+#define _GNU_SOURCE // Linux平台的memfd_create等扩展接口需要
 #include "port.h"
 #include "config.h"
+#include <errno.h>
 #include <stdbool.h>
 #include <stdio.h>
 
@@ -10,13 +12,30 @@
         return pthread_mutex_init(mutex, NULL) == 0;
     }
 
+    bool mutex_init_shared(mutex_t *mutex) {
+        // 进程间共享 + 健壮：持有者进程退出后，下一个加锁者得到EOWNERDEAD而不是永久阻塞
+        pthread_mutexattr_t attr;
+        if (pthread_mutexattr_init(&attr) != 0) {
+            return false;
+        }
+        bool ok = pthread_mutexattr_setpshared(&attr, PTHREAD_PROCESS_SHARED) == 0 &&
+                  pthread_mutexattr_setrobust(&attr, PTHREAD_MUTEX_ROBUST) == 0 &&
+                  pthread_mutex_init(mutex, &attr) == 0;
+        pthread_mutexattr_destroy(&attr);
+        return ok;
+    }
+
     void mutex_destroy(mutex_t *mutex) {
         pthread_mutex_destroy(mutex);
     }
 
     void mutex_lock(mutex_t *mutex) {
         DEBUG_PRINT("Linux平台：尝试获取互斥锁\n");
-        pthread_mutex_lock(mutex);
+        if (pthread_mutex_lock(mutex) == EOWNERDEAD) {
+            // 健壮锁的持有者进程已经退出，接管锁并标记为一致；
+            // 环形缓冲区的索引只在操作最后原子发布，持有者中途退出不会留下不一致的索引
+            pthread_mutex_consistent(mutex);
+        }
         DEBUG_PRINT("Linux平台：已获取互斥锁\n");
     }
 
@@ -25,12 +44,67 @@
         DEBUG_PRINT("Linux平台：已释放互斥锁\n");
     }
 
+    bool cond_init(cond_t *cond) {
+        // 使用默认属性，与COND_INITIALIZER静态初始化的条件变量完全相同
+        return pthread_cond_init(cond, NULL) == 0;
+    }
+
+    bool cond_init_shared(cond_t *cond) {
+        pthread_condattr_t attr;
+        if (pthread_condattr_init(&attr) != 0) {
+            return false;
+        }
+        bool ok = pthread_condattr_setpshared(&attr, PTHREAD_PROCESS_SHARED) == 0 &&
+                  pthread_cond_init(cond, &attr) == 0;
+        pthread_condattr_destroy(&attr);
+        return ok;
+    }
+
+    void cond_destroy(cond_t *cond) {
+        pthread_cond_destroy(cond);
+    }
+
+    bool cond_wait(cond_t *cond, mutex_t *mutex, uint32_t timeout_ms) {
+        int ret;
+        if (timeout_ms == PORT_WAIT_FOREVER) {
+            ret = pthread_cond_wait(cond, mutex);
+        } else {
+            struct timespec deadline;
+            clock_gettime(CLOCK_MONOTONIC, &deadline);
+            deadline.tv_sec += timeout_ms / 1000;
+            deadline.tv_nsec += (long)(timeout_ms % 1000) * 1000000L;
+            if (deadline.tv_nsec >= 1000000000L) {
+                deadline.tv_sec += 1;
+                deadline.tv_nsec -= 1000000000L;
+            }
+            // 超时按单调时钟计算，避免系统时间调整影响等待时长；
+            // 时钟由调用指定而不是由条件变量属性指定，静态初始化的条件变量同样适用
+            ret = pthread_cond_clockwait(cond, mutex, CLOCK_MONOTONIC, &deadline);
+        }
+        if (ret == EOWNERDEAD) {
+            // 与mutex_lock相同，重新获取健壮锁时发现持有者进程已经退出
+            pthread_mutex_consistent(mutex);
+            return true;
+        }
+        return ret == 0;
+    }
+
+    void cond_broadcast(cond_t *cond) {
+        pthread_cond_broadcast(cond);
+    }
+
     #elif defined(PLATFORM_FREERTOS)
     bool mutex_init(mutex_t *mutex) {
         *mutex = xSemaphoreCreateMutex();
         return *mutex != NULL;
     }
 
+    bool mutex_init_shared(mutex_t *mutex) {
+        // FreeRTOS没有进程的概念
+        (void)mutex;
+        return false;
+    }
+
     void mutex_destroy(mutex_t *mutex) {
         vSemaphoreDelete(*mutex);
     }
@@ -46,12 +120,57 @@
         DEBUG_PRINT("FreeRTOS平台：已释放互斥锁\n");
     }
 
+    bool cond_init(cond_t *cond) {
+        cond->sem = xSemaphoreCreateCounting(0x7FFF, 0);
+        cond->waiters = 0;
+        return cond->sem != NULL;
+    }
+
+    bool cond_init_shared(cond_t *cond) {
+        (void)cond;
+        return false;
+    }
+
+    void cond_destroy(cond_t *cond) {
+        vSemaphoreDelete(cond->sem);
+    }
+
+    bool cond_wait(cond_t *cond, mutex_t *mutex, uint32_t timeout_ms) {
+        TickType_t ticks = (timeout_ms == PORT_WAIT_FOREVER) ? portMAX_DELAY : pdMS_TO_TICKS(timeout_ms);
+        cond->waiters++;
+        mutex_unlock(mutex);
+        bool woken = xSemaphoreTake(cond->sem, ticks) == pdTRUE;
+        mutex_lock(mutex);
+        if (!woken) {
+            // 超时与重新加锁之间可能已有广播为本等待者释放了信号量并撤销了登记，
+            // 此时取走该信号量视为被唤醒；否则登记仍在，由等待者自行撤销，避免计数下溢
+            woken = xSemaphoreTake(cond->sem, 0) == pdTRUE;
+            if (!woken) {
+                cond->waiters--;
+            }
+        }
+        return woken;
+    }
+
+    void cond_broadcast(cond_t *cond) {
+        // 为每个登记的等待者释放一次信号量
+        while (cond->waiters > 0) {
+            xSemaphoreGive(cond->sem);
+            cond->waiters--;
+        }
+    }
+
     #elif defined(PLATFORM_BARE_METAL)
     bool mutex_init(mutex_t *mutex) {
         // 裸机平台无需初始化互斥锁
         return true;
     }
 
+    bool mutex_init_shared(mutex_t *mutex) {
+        // 裸机平台没有进程的概念
+        return false;
+    }
+
     void mutex_destroy(mutex_t *mutex) {
         // 裸机平台无需销毁互斥锁
     }
@@ -65,5 +184,339 @@
         // 裸机平台无需解锁
         DEBUG_PRINT("裸机平台：模拟释放互斥锁\n");
     }
+
+    bool cond_init(cond_t *cond) {
+        // 裸机平台无需初始化条件变量
+        return true;
+    }
+
+    bool cond_init_shared(cond_t *cond) {
+        return false;
+    }
+
+    void cond_destroy(cond_t *cond) {
+        // 裸机平台无需销毁条件变量
+    }
+
+    bool cond_wait(cond_t *cond, mutex_t *mutex, uint32_t timeout_ms) {
+        // 裸机平台没有其他线程能够改变条件，直接按超时处理
+        return false;
+    }
+
+    void cond_broadcast(cond_t *cond) {
+        // 裸机平台无需唤醒
+    }
     #endif
 #endif
+
+#if defined(PLATFORM_LINUX)
+#include <errno.h>
+#include <limits.h>
+#include <linux/futex.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+uint64_t time_now_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000u + (uint64_t)ts.tv_nsec / 1000000u;
+}
+
+void thread_yield(void)
+{
+    sched_yield();
+}
+
+bool futex_wait(atomic_uint *word, unsigned int expected, uint32_t timeout_ms, bool process_shared)
+{
+    struct timespec timeout;
+    struct timespec *timeout_ptr = NULL;
+    if (timeout_ms != PORT_WAIT_FOREVER)
+    {
+        // FUTEX_WAIT的超时时间为相对时间
+        timeout.tv_sec = timeout_ms / 1000;
+        timeout.tv_nsec = (long)(timeout_ms % 1000) * 1000000L;
+        timeout_ptr = &timeout;
+    }
+    // 只在同一进程内使用时，PRIVATE标志可以省去内核的跨进程查找；共享内存中的等待字必须使用共享的futex
+    int op = process_shared ? FUTEX_WAIT : FUTEX_WAIT_PRIVATE;
+    if (syscall(SYS_futex, (unsigned int *)word, op, expected, timeout_ptr, NULL, 0) != 0)
+    {
+        return errno != ETIMEDOUT; // EAGAIN表示值已改变，EINTR表示被信号中断
+    }
+    return true;
+}
+
+void futex_wake(atomic_uint *word, bool process_shared)
+{
+    syscall(SYS_futex, (unsigned int *)word, process_shared ? FUTEX_WAKE : FUTEX_WAKE_PRIVATE, INT_MAX, NULL, NULL, 0);
+}
+
+void *memory_mirror_alloc(size_t size)
+{
+    long page_size = sysconf(_SC_PAGESIZE);
+    if (size == 0 || page_size <= 0 || size % (size_t)page_size != 0)
+    {
+        return NULL; // 映射必须以页为单位
+    }
+
+    // 创建匿名内存对象作为两次映射共同的物理页来源
+    int fd = memfd_create("circular_buffer", MFD_CLOEXEC);
+    if (fd < 0)
+    {
+        return NULL;
+    }
+    if (ftruncate(fd, (off_t)size) != 0)
+    {
+        close(fd);
+        return NULL;
+    }
+
+    // 先保留连续2*size的虚拟地址区间，再将内存对象固定映射到前后两半
+    char *addr = mmap(NULL, 2 * size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (addr == MAP_FAILED)
+    {
+        close(fd);
+        return NULL;
+    }
+    if (mmap(addr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED ||
+        mmap(addr + size, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED)
+    {
+        munmap(addr, 2 * size);
+        close(fd);
+        return NULL;
+    }
+    close(fd); // 映射建立后不再需要文件描述符
+    DEBUG_PRINT("Linux平台：已建立镜像映射 %p, 大小 %zu\n", (void *)addr, size);
+    return addr;
+}
+
+void memory_mirror_free(void *addr, size_t size)
+{
+    munmap(addr, 2 * size);
+}
+
+// NUMA内存策略，与<linux/mempolicy.h>一致，直接使用系统调用，不依赖libnuma
+#define NUMA_MPOL_BIND            2
+#define NUMA_MPOL_INTERLEAVE      3
+#define NUMA_MPOL_F_MEMS_ALLOWED  (1 << 2)
+#define NUMA_MAX_NODES            1024
+#define NUMA_MASK_WORDS           (NUMA_MAX_NODES / (8 * sizeof(unsigned long)))
+
+/**
+ * @brief 按提示设置映射区域的NUMA策略
+ *
+ * @param addr 映射起始地址
+ * @param size 映射大小
+ * @param hints PORT_MEMORY_NUMA_BIND或PORT_MEMORY_NUMA_INTERLEAVE
+ * @param numa_node 绑定时的节点编号
+ * @return 设置成功返回true
+ */
+static bool memory_set_numa_policy(void *addr, size_t size, unsigned int hints, int numa_node)
+{
+    unsigned long mask[NUMA_MASK_WORDS] = {0};
+    int mode;
+    if (hints & PORT_MEMORY_NUMA_BIND)
+    {
+        if (numa_node < 0 || numa_node >= NUMA_MAX_NODES)
+        {
+            return false;
+        }
+        mask[numa_node / (8 * sizeof(unsigned long))] = 1ul << (numa_node % (8 * sizeof(unsigned long)));
+        mode = NUMA_MPOL_BIND;
+    }
+    else
+    {
+        // 交错分布在进程允许使用的全部节点上
+        if (syscall(SYS_get_mempolicy, NULL, mask, (unsigned long)NUMA_MAX_NODES, NULL,
+                    (unsigned long)NUMA_MPOL_F_MEMS_ALLOWED) != 0)
+        {
+            return false;
+        }
+        mode = NUMA_MPOL_INTERLEAVE;
+    }
+    return syscall(SYS_mbind, addr, size, mode, mask, (unsigned long)NUMA_MAX_NODES, 0u) == 0;
+}
+
+/**
+ * @brief 映射按大页大小对齐的匿名内存
+ *
+ * 多映射一个大页的长度，再截掉首尾未对齐的部分，保证透明大页可以覆盖整个区域。
+ *
+ * @param size 映射大小
+ * @return 成功返回对齐的起始地址，失败返回NULL
+ */
+static void *memory_map_aligned(size_t size)
+{
+    size_t align = CIRCULAR_BUFFER_HUGE_PAGE_SIZE;
+    char *raw = mmap(NULL, size + align, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED)
+    {
+        return NULL;
+    }
+    char *addr = (char *)(((uintptr_t)raw + align - 1) & ~(uintptr_t)(align - 1));
+    if (addr > raw)
+    {
+        munmap(raw, (size_t)(addr - raw));
+    }
+    if (addr + size < raw + size + align)
+    {
+        munmap(addr + size, (size_t)(raw + size + align - (addr + size)));
+    }
+    return addr;
+}
+
+void *memory_large_alloc(size_t size, unsigned int hints, int numa_node, unsigned int *applied)
+{
+    unsigned int done = 0;
+    char *addr = NULL;
+    if (size == 0)
+    {
+        return NULL;
+    }
+
+    // 显式大页需要系统预留了足够的大页，失败时回退到透明大页
+    if ((hints & PORT_MEMORY_HUGE_PAGES) && size % CIRCULAR_BUFFER_HUGE_PAGE_SIZE == 0)
+    {
+        addr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (addr == MAP_FAILED)
+        {
+            addr = NULL;
+        }
+        else
+        {
+            done |= PORT_MEMORY_HUGE_PAGES;
+        }
+    }
+    if (addr == NULL)
+    {
+        addr = memory_map_aligned(size);
+        if (addr == NULL)
+        {
+            return NULL;
+        }
+        if ((hints & (PORT_MEMORY_HUGE_PAGES | PORT_MEMORY_TRANSPARENT_HUGE_PAGES)) &&
+            madvise(addr, size, MADV_HUGEPAGE) == 0)
+        {
+            done |= PORT_MEMORY_TRANSPARENT_HUGE_PAGES;
+        }
+    }
+
+    // 策略必须在首次访问之前设置，之后缺页时才会按策略分配物理页
+    if ((hints & (PORT_MEMORY_NUMA_BIND | PORT_MEMORY_NUMA_INTERLEAVE)) &&
+        memory_set_numa_policy(addr, size, hints, numa_node))
+    {
+        done |= hints & (PORT_MEMORY_NUMA_BIND | PORT_MEMORY_NUMA_INTERLEAVE);
+    }
+
+    if (done == 0)
+    {
+        munmap(addr, size); // 没有任何提示生效，交给调用者使用普通分配
+        return NULL;
+    }
+    DEBUG_PRINT("Linux平台：已分配大块内存 %p, 大小 %zu, 生效提示 0x%x\n", (void *)addr, size, done);
+    if (applied != NULL)
+    {
+        *applied = done;
+    }
+    return addr;
+}
+
+void memory_large_free(void *addr, size_t size)
+{
+    munmap(addr, size);
+}
+
+#else
+#if defined(PLATFORM_FREERTOS)
+#include "FreeRTOS.h"
+#include "task.h"
+
+uint64_t time_now_ms(void)
+{
+    return (uint64_t)xTaskGetTickCount() * portTICK_PERIOD_MS;
+}
+
+void thread_yield(void)
+{
+    taskYIELD();
+}
+
+bool futex_wait(atomic_uint *word, unsigned int expected, uint32_t timeout_ms, bool process_shared)
+{
+    // FreeRTOS没有futex，让出一次CPU后由调用者重新检查条件
+    (void)word;
+    (void)expected;
+    (void)timeout_ms;
+    (void)process_shared;
+    taskYIELD();
+    return true;
+}
+
+void futex_wake(atomic_uint *word, bool process_shared)
+{
+    (void)word;
+    (void)process_shared;
+}
+#else
+uint64_t time_now_ms(void)
+{
+    // 裸机平台没有通用的时间源（PORT_HAS_CLOCK为0），有限超时的等待在自旋阶段结束后即超时
+    return 0;
+}
+
+void thread_yield(void)
+{
+    // 裸机平台没有其他线程
+}
+
+bool futex_wait(atomic_uint *word, unsigned int expected, uint32_t timeout_ms, bool process_shared)
+{
+    // 裸机平台只有中断会改变条件，直接返回由调用者重新检查
+    (void)word;
+    (void)expected;
+    (void)timeout_ms;
+    (void)process_shared;
+    return true;
+}
+
+void futex_wake(atomic_uint *word, bool process_shared)
+{
+    (void)word;
+    (void)process_shared;
+}
+#endif
+
+void *memory_mirror_alloc(size_t size)
+{
+    // 该平台不支持虚拟内存镜像映射
+    (void)size;
+    return NULL;
+}
+
+void memory_mirror_free(void *addr, size_t size)
+{
+    (void)addr;
+    (void)size;
+}
+
+void *memory_large_alloc(size_t size, unsigned int hints, int numa_node, unsigned int *applied)
+{
+    // 该平台没有虚拟内存页面和NUMA策略，由调用者使用普通分配
+    (void)size;
+    (void)hints;
+    (void)numa_node;
+    (void)applied;
+    return NULL;
+}
+
+void memory_large_free(void *addr, size_t size)
+{
+    (void)addr;
+    (void)size;
+}
+#endif
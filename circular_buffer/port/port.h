@@ -3,20 +3,55 @@
 #define PORT_H
 
 #include "config.h"
+#include <stdatomic.h>
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @def PORT_WAIT_FOREVER
+ * @brief 无限等待的超时时间
+ */
+#define PORT_WAIT_FOREVER UINT32_MAX
+
+/**
+ * @def PORT_HAS_CLOCK
+ * @brief 平台是否提供单调时间源
+ *
+ * 裸机平台的time_now_ms恒为0，有限超时的等待无法计时，等待接口在自旋阶段结束后即按超时返回；
+ * 无限等待不受影响。
+ */
+#if defined(PLATFORM_LINUX) || defined(PLATFORM_FREERTOS)
+#define PORT_HAS_CLOCK 1
+#else
+#define PORT_HAS_CLOCK 0
+#endif
 
 #if ENABLE_LOCK
     #if defined(PLATFORM_LINUX)
     #include <pthread.h>
     typedef pthread_mutex_t mutex_t;
+    typedef pthread_cond_t cond_t;
+    // 静态初始化，与mutex_init/cond_init的结果等价，可用于文件作用域的对象
+    #define MUTEX_INITIALIZER PTHREAD_MUTEX_INITIALIZER
+    #define COND_INITIALIZER  PTHREAD_COND_INITIALIZER
     #elif defined(PLATFORM_FREERTOS)
     #include "FreeRTOS.h"
     #include "semphr.h"
     typedef SemaphoreHandle_t mutex_t;
+    // FreeRTOS没有条件变量，使用计数信号量和等待者计数模拟
+    typedef struct {
+        SemaphoreHandle_t sem; /**< 唤醒信号量 */
+        UBaseType_t waiters;   /**< 等待者数量，由关联的互斥锁保护 */
+    } cond_t;
     #elif defined(PLATFORM_BARE_METAL)
     // 在裸机平台上，定义一个空的互斥锁结构
     typedef struct {} mutex_t;
+    typedef struct {} cond_t;
+    #define MUTEX_INITIALIZER {}
+    #define COND_INITIALIZER  {}
     #endif
+    // FreeRTOS的信号量必须在运行时创建，没有静态初始化，不定义MUTEX_INITIALIZER
 
     /**
      * @brief 初始化互斥锁
@@ -26,6 +61,17 @@
      */
     bool mutex_init(mutex_t *mutex);
 
+    /**
+     * @brief 初始化可以放在共享内存中、供多个进程使用的互斥锁
+     *
+     * 锁是健壮的：持有锁的进程退出后，下一次mutex_lock接管锁而不是永久阻塞。
+     * 仅Linux平台支持，其他平台返回false。
+     * 
+     * @param mutex 互斥锁指针，位于共享内存中
+     * @return 成功返回true，失败返回false
+     */
+    bool mutex_init_shared(mutex_t *mutex);
+
     /**
      * @brief 销毁互斥锁
      * 
@@ -46,16 +92,153 @@
      * @param mutex 互斥锁指针
      */
     void mutex_unlock(mutex_t *mutex);
+
+    /**
+     * @brief 初始化条件变量
+     * 
+     * @param cond 条件变量指针
+     * @return 成功返回true，失败返回false
+     */
+    bool cond_init(cond_t *cond);
+
+    /**
+     * @brief 初始化可以放在共享内存中、供多个进程使用的条件变量
+     *
+     * 仅Linux平台支持，其他平台返回false。
+     * 
+     * @param cond 条件变量指针，位于共享内存中
+     * @return 成功返回true，失败返回false
+     */
+    bool cond_init_shared(cond_t *cond);
+
+    /**
+     * @brief 销毁条件变量
+     * 
+     * @param cond 条件变量指针
+     */
+    void cond_destroy(cond_t *cond);
+
+    /**
+     * @brief 在持有互斥锁的情况下等待条件变量，最多等待timeout_ms毫秒
+     *
+     * 等待期间释放互斥锁，返回前重新获取。可能被虚假唤醒，调用者需要循环检查条件。
+     * 
+     * @param cond 条件变量指针
+     * @param mutex 已持有的互斥锁指针
+     * @param timeout_ms 超时时间（毫秒），PORT_WAIT_FOREVER表示无限等待
+     * @return 被唤醒返回true，超时返回false
+     */
+    bool cond_wait(cond_t *cond, mutex_t *mutex, uint32_t timeout_ms);
+
+    /**
+     * @brief 唤醒所有等待条件变量的线程，调用者需持有关联的互斥锁
+     * 
+     * @param cond 条件变量指针
+     */
+    void cond_broadcast(cond_t *cond);
 #else
     // 如果不启用锁，定义空的锁操作
     typedef struct {} mutex_t;
 
     #define mutex_init(mutex)   (true)
+    #define mutex_init_shared(mutex) (true)
     #define mutex_destroy(mutex) ((void)0)
     #define mutex_lock(mutex)    ((void)0)
     #define mutex_unlock(mutex)  ((void)0)
 #endif
 
+/**
+ * @brief 获取单调递增的时间（毫秒）
+ *
+ * 用于计算等待接口的截止时间，裸机平台没有时间源时返回0。
+ *
+ * @return 当前时间（毫秒）
+ */
+uint64_t time_now_ms(void);
+
+/**
+ * @brief 让出CPU，给其他线程或任务运行的机会
+ */
+void thread_yield(void);
+
+/**
+ * @brief 当*word等于expected时休眠，直到被futex_wake唤醒或超时
+ *
+ * Linux平台基于futex实现，检查与休眠在内核中原子完成，不会丢失唤醒；
+ * 其他平台退化为让出一次CPU后返回，调用者需要循环检查条件。
+ *
+ * @param word 等待字地址
+ * @param expected 期望值，*word不等于该值时立即返回
+ * @param timeout_ms 超时时间（毫秒），PORT_WAIT_FOREVER表示无限等待
+ * @param process_shared 等待字位于多个进程共享的内存中，需要跨进程唤醒
+ * @return 超时返回false，被唤醒、值已改变或被信号中断返回true
+ */
+bool futex_wait(atomic_uint *word, unsigned int expected, uint32_t timeout_ms, bool process_shared);
+
+/**
+ * @brief 唤醒所有在word上休眠的线程
+ *
+ * @param word 等待字地址
+ * @param process_shared 与futex_wait的同名参数一致
+ */
+void futex_wake(atomic_uint *word, bool process_shared);
+
+/**
+ * @brief 分配镜像映射内存
+ *
+ * 创建一个大小为size的匿名内存对象，并在虚拟地址空间中连续映射两次，
+ * 使得[addr, addr + 2 * size)中addr + i与addr + size + i指向同一物理页。
+ * 仅Linux平台支持，其他平台返回NULL。
+ *
+ * @param size 内存对象大小，必须为页大小的整数倍
+ * @return 成功返回映射起始地址，失败或平台不支持返回NULL
+ */
+void *memory_mirror_alloc(size_t size);
+
+/**
+ * @brief 释放镜像映射内存
+ *
+ * @param addr memory_mirror_alloc返回的地址
+ * @param size 分配时的内存对象大小
+ */
+void memory_mirror_free(void *addr, size_t size);
+
+/**
+ * @brief 大块内存的页面和NUMA放置提示，供memory_large_alloc使用
+ */
+enum
+{
+    PORT_MEMORY_HUGE_PAGES = 1u << 0,             /**< 显式大页（hugetlbfs预留的大页） */
+    PORT_MEMORY_TRANSPARENT_HUGE_PAGES = 1u << 1, /**< 透明大页 */
+    PORT_MEMORY_NUMA_BIND = 1u << 2,              /**< 绑定到指定的NUMA节点 */
+    PORT_MEMORY_NUMA_INTERLEAVE = 1u << 3,        /**< 在进程允许的全部NUMA节点间交错分布 */
+};
+
+/**
+ * @brief 按页面和NUMA放置提示分配大块内存
+ *
+ * 各提示尽力而为，逐级回退：显式大页不可用时改用透明大页，透明大页不可用时使用普通页；
+ * NUMA策略设置失败时保持默认策略。内存在首次访问时才按策略分配物理页，
+ * 调用者在写入前不应访问这块内存。
+ * 所有请求的提示都未能生效时释放映射并返回NULL，由调用者改用普通分配。
+ * 仅Linux平台支持，其他平台返回NULL。
+ *
+ * @param size 内存大小
+ * @param hints PORT_MEMORY_*提示的组合
+ * @param numa_node 指定PORT_MEMORY_NUMA_BIND时绑定的节点编号
+ * @param applied 返回实际生效的提示组合，可以为NULL
+ * @return 成功返回映射起始地址，失败返回NULL
+ */
+void *memory_large_alloc(size_t size, unsigned int hints, int numa_node, unsigned int *applied);
+
+/**
+ * @brief 释放memory_large_alloc分配的内存
+ *
+ * @param addr memory_large_alloc返回的地址
+ * @param size 分配时的内存大小
+ */
+void memory_large_free(void *addr, size_t size);
+
 #if ENABLE_DEBUG
 #include <stdio.h>
 #define DEBUG_PRINT(fmt, ...) printf(fmt, ##__VA_ARGS__)
@@ -1,309 +1,2074 @@
 // circular_buffer.c
 #include "circular_buffer.h"
+#include "circular_buffer_internal.h"
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
 
+// 读写分离锁模式下生产者和消费者各自使用独立的互斥锁，否则共用同一把锁
+#if CIRCULAR_BUFFER_USE_SPLIT_LOCK
+#define PRODUCER_MUTEX(cb) (&(cb)->write_mutex)
+#define CONSUMER_MUTEX(cb) (&(cb)->read_mutex)
+#else
+#define PRODUCER_MUTEX(cb) (&(cb)->mutex)
+#define CONSUMER_MUTEX(cb) (&(cb)->mutex)
+#endif
+
+/**
+ * @brief 计算从offset开始可以连续访问的长度
+ *
+ * 镜像映射的缓冲区中，任意位置开始、长度不超过size的区域都是连续的，
+ * 直接返回length，无需拆分；普通缓冲区中连续区域截止到环绕点。
+ *
+ * @param cb 环形缓冲区结构体指针
+ * @param offset 起始位置（已经过掩码处理）
+ * @param length 需要访问的长度（不超过size）
+ * @return 第一段连续区域的长度
+ */
+static size_t contiguous_length(const circular_buffer *cb, size_t offset, size_t length)
+{
+    if (cb->flags & CIRCULAR_BUFFER_FLAG_MIRROR)
+    {
+        return length;
+    }
+    size_t first = cb->size - offset;
+    return (first < length) ? first : length;
+}
+
+/**
+ * @brief 检查环形缓冲区是否由多个进程共享，等待和唤醒需要跨进程
+ *
+ * @param cb 环形缓冲区结构体指针
+ * @return 共享返回true
+ */
+static inline bool is_shared(const circular_buffer *cb)
+{
+    return (cb->flags & CIRCULAR_BUFFER_FLAG_SHARED) != 0;
+}
+
+/**
+ * @brief 将数据拷贝到缓冲区指定位置，自动处理环绕
+ *
+ * 一次传输最多被拆分为两段连续区间：环绕点之前的一段和环绕点之后的一段，
+ * 每段使用一次memcpy完成批量拷贝，避免逐字节写入和逐字节取模。
+ *
+ * @param cb 环形缓冲区结构体指针
+ * @param offset 写入起始位置（已经过掩码处理）
+ * @param data 写入数据的指针
+ * @param length 写入数据的长度（不超过size）
+ */
+static void copy_to_buffer(circular_buffer *cb, size_t offset, const char *data, size_t length)
+{
+    // 计算环绕点之前可以连续写入的长度
+    // 假设size = 8, offset = 6, length = 4
+    // first = min(4, 8 - 6) = 2，剩余2字节从缓冲区起始位置写入
+    // 图示:
+    //              offset
+    //                 |
+    // [3][4][ ][ ][ ][ ][1][2]
+    //  第二段            第一段
+    // 镜像映射的缓冲区中first总是等于length，只需一次拷贝
+    size_t first = contiguous_length(cb, offset, length);
+    char *buffer = circular_buffer_data_base(cb);
+    memcpy(buffer + offset, data, first); // 第一段：offset到环绕点
+    if (length > first)
+    {
+        memcpy(buffer, data + first, length - first); // 第二段：环绕点之后
+    }
+}
+
+/**
+ * @brief 从缓冲区指定位置拷贝数据，自动处理环绕
+ *
+ * @param cb 环形缓冲区结构体指针
+ * @param offset 读取起始位置（已经过掩码处理）
+ * @param data 读取数据的指针
+ * @param length 读取数据的长度（不超过size）
+ */
+static void copy_from_buffer(const circular_buffer *cb, size_t offset, char *data, size_t length)
+{
+    // 与copy_to_buffer相同，按环绕点拆分为最多两段连续区间
+    size_t first = contiguous_length(cb, offset, length);
+    const char *buffer = circular_buffer_data_base(cb);
+    memcpy(data, buffer + offset, first); // 第一段：offset到环绕点
+    if (length > first)
+    {
+        memcpy(data + first, buffer, length - first); // 第二段：环绕点之后
+    }
+}
+
+/**
+ * @brief 将缓冲区内从offset开始、长度为length的区域描述为最多两段连续内存
+ *
+ * @param cb 环形缓冲区结构体指针
+ * @param offset 区域起始位置（已经过掩码处理）
+ * @param length 区域长度（不超过size）
+ * @param spans 返回的连续内存段
+ */
+static void fill_spans(const circular_buffer *cb, size_t offset, size_t length, circular_buffer_spans *spans)
+{
+    // 与copy_to_buffer相同的拆分方式，第一段到环绕点为止，第二段从缓冲区起始位置开始
+    // 镜像映射的缓冲区总是只有一段
+    size_t first = contiguous_length(cb, offset, length);
+    spans->span[0].data = circular_buffer_data_base(cb) + offset;
+    spans->span[0].length = first;
+    spans->span[1].data = circular_buffer_data_base(cb);
+    spans->span[1].length = length - first;
+    spans->count = (length == 0) ? 0 : (length > first) ? 2 : 1;
+}
+
+#if !CIRCULAR_BUFFER_USE_SPLIT_LOCK
+// 读写分离锁模式下通知方不持有等待方的锁，统一使用下面的*_unlocked版本
+/**
+ * @brief 通知等待数据的读取端
+ *
+ * 只在有读取端登记等待时才唤醒，无人等待时不会发起系统调用。
+ * 启用锁时调用者需持有读写共用的互斥锁，等待者在持锁期间登记；
+ * 关闭锁时，发布end之后的全序屏障与读取端登记等待标志之后的全序屏障配对：
+ * 要么这里看到等待标志，要么读取端休眠前的重新检查看到新的end，不会丢失唤醒。
+ *
+ * @param cb 环形缓冲区结构体指针
+ */
+static void notify_readable(circular_buffer *cb)
+{
+#if ENABLE_LOCK
+    if (atomic_load_explicit(&cb->read_waiters, memory_order_relaxed) > 0)
+    {
+        cond_broadcast(&cb->readable);
+    }
+#else
+    atomic_thread_fence(memory_order_seq_cst);
+    if (atomic_load_explicit(&cb->read_wait, memory_order_relaxed) != 0)
+    {
+        atomic_store_explicit(&cb->read_wait, 0, memory_order_relaxed);
+        futex_wake(&cb->read_wait, is_shared(cb));
+    }
+#endif
+}
+
+/**
+ * @brief 通知等待空间的写入端
+ *
+ * @param cb 环形缓冲区结构体指针
+ */
+static void notify_writable(circular_buffer *cb)
+{
+#if ENABLE_LOCK
+    if (atomic_load_explicit(&cb->write_waiters, memory_order_relaxed) > 0)
+    {
+        cond_broadcast(&cb->writable);
+    }
+#else
+    // 与notify_readable对称
+    atomic_thread_fence(memory_order_seq_cst);
+    if (atomic_load_explicit(&cb->write_wait, memory_order_relaxed) != 0)
+    {
+        atomic_store_explicit(&cb->write_wait, 0, memory_order_relaxed);
+        futex_wake(&cb->write_wait, is_shared(cb));
+    }
+#endif
+}
+#endif
+
+/**
+ * @brief 通知等待数据的读取端，调用者不持有消费者锁
+ *
+ * 用于多生产者模式和读写分离锁模式，写入端发布数据时不持有读取端等待所用的互斥锁。
+ * 启用锁时，发布end之后的全序屏障与读取端登记等待者之后的全序屏障配对：
+ * 要么这里看到等待者计数，加锁后广播；要么读取端休眠前的重新检查看到新的end。
+ * 读取端从重新检查到进入cond_wait期间一直持有互斥锁，因此广播不会早于读取端休眠。
+ * 无人等待时只多一次屏障和计数判断，不会争抢互斥锁。
+ * 两种模式下都会在开头执行一次全序屏障，调用者可以借用这次屏障检查自己的等待标志。
+ *
+ * @param cb 环形缓冲区结构体指针
+ */
+static void notify_readable_unlocked(circular_buffer *cb)
+{
+#if ENABLE_LOCK
+    atomic_thread_fence(memory_order_seq_cst);
+    if (atomic_load_explicit(&cb->read_waiters, memory_order_relaxed) > 0)
+    {
+        mutex_lock(CONSUMER_MUTEX(cb));
+        cond_broadcast(&cb->readable);
+        mutex_unlock(CONSUMER_MUTEX(cb));
+    }
+#else
+    notify_readable(cb); // 无锁模式下的futex通知本身不依赖互斥锁
+#endif
+}
+
+#if CIRCULAR_BUFFER_USE_SPLIT_LOCK
+/**
+ * @brief 读写分离锁模式下通知等待空间的写入端，调用者不持有生产者锁
+ *
+ * 与notify_readable_unlocked对称，写入端在持有生产者锁期间登记等待并重新检查start。
+ *
+ * @param cb 环形缓冲区结构体指针
+ */
+static void notify_writable_unlocked(circular_buffer *cb)
+{
+    atomic_thread_fence(memory_order_seq_cst);
+    if (atomic_load_explicit(&cb->write_waiters, memory_order_relaxed) > 0)
+    {
+        mutex_lock(PRODUCER_MUTEX(cb));
+        cond_broadcast(&cb->writable);
+        mutex_unlock(PRODUCER_MUTEX(cb));
+    }
+}
+#endif
+
+/**
+ * @brief 生产者发布数据后释放生产者锁并通知读取端
+ *
+ * 读写共用一把锁时在锁内检查等待者并通知，再解锁；
+ * 读写分离锁模式下先释放生产者锁，再获取消费者锁发出通知。
+ * 生产者和消费者持有自己的锁时都不会为了通知去获取对方的锁，避免两把锁交叉加锁导致死锁。
+ *
+ * @param cb 环形缓冲区结构体指针
+ */
+static void producer_unlock_notify(circular_buffer *cb)
+{
+#if CIRCULAR_BUFFER_USE_SPLIT_LOCK
+    mutex_unlock(PRODUCER_MUTEX(cb));
+    notify_readable_unlocked(cb);
+#else
+    notify_readable(cb);
+    mutex_unlock(PRODUCER_MUTEX(cb));
+#endif
+}
+
+/**
+ * @brief 消费者释放空间后释放消费者锁并通知写入端
+ *
+ * @param cb 环形缓冲区结构体指针
+ */
+static void consumer_unlock_notify(circular_buffer *cb)
+{
+#if CIRCULAR_BUFFER_USE_SPLIT_LOCK
+    mutex_unlock(CONSUMER_MUTEX(cb));
+    notify_writable_unlocked(cb);
+#else
+    notify_writable(cb);
+    mutex_unlock(CONSUMER_MUTEX(cb));
+#endif
+}
+
+/**
+ * @brief 多生产者模式下认领一段可写空间
+ *
+ * 通过CAS将claim从position推进到position + 认领长度，认领成功后这段空间只属于当前生产者。
+ * 剩余空间不足时不能用fetch-add盲目推进游标，因此使用CAS：先检查空间，再原子地推进。
+ * 读取start使用acquire，保证消费者对这段空间的读取已经完成。
+ *
+ * @param cb 环形缓冲区结构体指针
+ * @param length 请求认领的长度
+ * @param partial true时空间不足则认领剩余的全部空间，false时空间不足直接失败
+ * @param position 返回认领区域的起始位置（自由增长的计数器）
+ * @return 实际认领的长度，为0表示没有认领到空间
+ */
+static size_t multi_producer_claim(circular_buffer *cb, size_t length, bool partial, size_t *position)
+{
+    size_t claim = atomic_load_explicit(&cb->claim, memory_order_relaxed);
+    for (;;)
+    {
+        size_t start = atomic_load_explicit(&cb->start, memory_order_acquire);
+        size_t used = claim - start;
+        if (used > cb->size)
+        {
+            // 先读到的claim早于后读到的start，差值回绕，重新读取claim
+            claim = atomic_load_explicit(&cb->claim, memory_order_relaxed);
+            continue;
+        }
+        size_t available_space = cb->size - used;
+        size_t amount = length;
+        if (available_space < length)
+        {
+            if (!partial || available_space == 0)
+            {
+                return 0; // 剩余空间不足
+            }
+            amount = available_space;
+        }
+        // CAS失败时claim被更新为最新值，重新检查剩余空间
+        if (atomic_compare_exchange_weak_explicit(&cb->claim, &claim, claim + amount, memory_order_relaxed,
+                                                  memory_order_relaxed))
+        {
+            *position = claim;
+            return amount;
+        }
+    }
+}
+
+/**
+ * @brief 多生产者模式下按认领顺序发布一段已经写好的区域
+ *
+ * 等待前序生产者全部发布（end追上position）后，再将end推进到position + length。
+ * 等待方式和内存序见multi_producer_publish。
+ *
+ * @param cb 环形缓冲区结构体指针
+ * @param position 认领区域的起始位置
+ * @param length 认领区域的长度
+ */
+static void multi_producer_release(circular_buffer *cb, size_t position, size_t length)
+{
+    unsigned int spins = 0;
+    while (atomic_load_explicit(&cb->end, memory_order_acquire) != position)
+    {
+        if (spins < CIRCULAR_BUFFER_SPIN_COUNT)
+        {
+            spins++;
+            continue;
+        }
+        // 先登记等待标志，再重新检查end，与下面发布之后的屏障配对
+        atomic_store_explicit(&cb->publish_wait, 1, memory_order_relaxed);
+        atomic_thread_fence(memory_order_seq_cst);
+        if (atomic_load_explicit(&cb->end, memory_order_relaxed) != position)
+        {
+            futex_wait(&cb->publish_wait, 1, PORT_WAIT_FOREVER, is_shared(cb));
+        }
+    }
+    atomic_store_explicit(&cb->end, position + length, memory_order_release);
+    notify_readable_unlocked(cb); // 有读取端在等待时唤醒
+    // notify_readable_unlocked在发布end之后已经执行过全序屏障，这里直接检查等待标志
+    // 唤醒等待前序发布的其他生产者，多个等待者共用一个标志，唤醒全部后各自重新检查
+    if (atomic_load_explicit(&cb->publish_wait, memory_order_relaxed) != 0)
+    {
+        atomic_store_explicit(&cb->publish_wait, 0, memory_order_relaxed);
+        futex_wake(&cb->publish_wait, is_shared(cb));
+    }
+}
+
+/**
+ * @brief 多生产者模式下写入认领的空间并按认领顺序发布
+ *
+ * 拷贝数据可以与其他生产者并行进行；发布时必须等待前面认领的区域全部发布
+ * （end等于position），再将end推进到自己的结束位置，保证end之前的数据都已完整写入。
+ * 等待时先自旋，超过CIRCULAR_BUFFER_SPIN_COUNT次后在publish_wait上休眠：
+ * 生产者数量超过CPU核数时，前一个生产者可能在认领之后被抢占，让出CPU并不能保证它被调度，
+ * 休眠则把CPU真正交给它。发布后只在有人登记等待时才发起唤醒系统调用。
+ * 读取end使用acquire：前一个生产者的数据通过它的release发布对当前生产者可见，
+ * 当前生产者再以release发布，消费者acquire读取后即可看到之前所有生产者的数据。
+ *
+ * 图示（size = 8，生产者A认领[0, 3)，生产者B认领[3, 5)）:
+ *  end        claim
+ *   |           |
+ *  [A][A][A][B][B][ ][ ][ ]
+ * B先拷贝完成时也要等待A将end推进到3，再将end推进到5。
+ *
+ * @param cb 环形缓冲区结构体指针
+ * @param position 认领区域的起始位置
+ * @param data 写入数据的指针
+ * @param length 认领的长度
+ */
+static void multi_producer_publish(circular_buffer *cb, size_t position, const char *data, size_t length)
+{
+    copy_to_buffer(cb, position & (cb->size - 1), data, length);
+    multi_producer_release(cb, position, length);
+}
+
+/**
+ * @brief 计算距离截止时间的剩余等待时间
+ *
+ * @param deadline 截止时间（毫秒）
+ * @param timeout_ms 调用者传入的超时时间，PORT_WAIT_FOREVER表示无限等待
+ * @return 剩余等待时间（毫秒），已到期返回0
+ */
+static uint32_t remaining_ms(uint64_t deadline, uint32_t timeout_ms)
+{
+    if (timeout_ms == PORT_WAIT_FOREVER)
+    {
+        return PORT_WAIT_FOREVER;
+    }
+#if !PORT_HAS_CLOCK
+    // 没有时间源时时间永远不会流逝，有限超时视为已到期，避免永久等待
+    (void)deadline;
+    return 0;
+#else
+    uint64_t now = time_now_ms();
+    return (now >= deadline) ? 0 : (uint32_t)(deadline - now);
+#endif
+}
+
+/**
+ * @brief 生产者获取用于计算剩余空间的start
+ *
+ * 索引分离布局下优先使用生产者本地缓存的start，缓存视图显示剩余空间足够时
+ * 完全不访问消费者所在的缓存行；只有缓存视图显示空间不足时才以acquire语义
+ * 重新读取共享的start并刷新缓存。缓存的start只会落后于真实值，据此算出的
+ * 剩余空间只会偏小，因此不会覆盖尚未读走的数据。
+ *
+ * @param cb 环形缓冲区结构体指针
+ * @param end 生产者当前的end
+ * @param length 需要的剩余空间
+ * @return 用于计算剩余空间的start
+ */
+static size_t producer_load_start(circular_buffer *cb, size_t end, size_t length)
+{
+    size_t start;
+#if CIRCULAR_BUFFER_SEPARATE_INDEX
+    start = cb->cached_start;
+    if (end - start <= cb->size && cb->size - (end - start) >= length)
+    {
+        return start; // 缓存视图空间足够，无需访问共享的start
+    }
+    start = atomic_load_explicit(&cb->start, memory_order_acquire);
+    cb->cached_start = start;
+#else
+    (void)length;
+    start = atomic_load_explicit(&cb->start, memory_order_acquire);
+#endif
+    // 无锁覆盖模式下写入端不移动start，被套圈的读取端尚未重新同步时start可能落后end超过size，
+    // 此时按缓冲区已满处理，避免剩余空间的计算回绕
+    return (end - start > cb->size) ? end - cb->size : start;
+}
+
+/**
+ * @brief 消费者获取用于计算有效数据长度的end
+ *
+ * 与producer_load_start对称：缓存视图显示数据足够时不访问生产者所在的缓存行，
+ * 否则以acquire语义重新读取共享的end并刷新缓存。
+ *
+ * @param cb 环形缓冲区结构体指针
+ * @param start 消费者当前的start
+ * @param length 需要的数据长度
+ * @return 用于计算有效数据长度的end
+ */
+static size_t consumer_load_end(circular_buffer *cb, size_t start, size_t length)
+{
+#if CIRCULAR_BUFFER_SEPARATE_INDEX
+    size_t end = cb->cached_end;
+    if (end - start >= length)
+    {
+        return end; // 缓存视图数据足够，无需访问共享的end
+    }
+    end = atomic_load_explicit(&cb->end, memory_order_acquire);
+    cb->cached_end = end;
+    return end;
+#else
+    (void)start;
+    (void)length;
+    return atomic_load_explicit(&cb->end, memory_order_acquire);
+#endif
+}
+
+// 大页和NUMA放置提示，由port层的memory_large_alloc实现
+#define LARGE_MEMORY_FLAGS                                                                                   \
+    (CIRCULAR_BUFFER_FLAG_HUGE_PAGES | CIRCULAR_BUFFER_FLAG_TRANSPARENT_HUGE_PAGES |                         \
+     CIRCULAR_BUFFER_FLAG_NUMA_BIND | CIRCULAR_BUFFER_FLAG_NUMA_INTERLEAVE)
+
+/**
+ * @brief 将初始化选项中的内存放置提示转换为port层的提示
+ *
+ * @param flags CIRCULAR_BUFFER_FLAG_*的组合
+ * @return PORT_MEMORY_*的组合
+ */
+static unsigned int large_memory_hints(unsigned int flags)
+{
+    return ((flags & CIRCULAR_BUFFER_FLAG_HUGE_PAGES) ? PORT_MEMORY_HUGE_PAGES : 0u) |
+           ((flags & CIRCULAR_BUFFER_FLAG_TRANSPARENT_HUGE_PAGES) ? PORT_MEMORY_TRANSPARENT_HUGE_PAGES : 0u) |
+           ((flags & CIRCULAR_BUFFER_FLAG_NUMA_BIND) ? PORT_MEMORY_NUMA_BIND : 0u) |
+           ((flags & CIRCULAR_BUFFER_FLAG_NUMA_INTERLEAVE) ? PORT_MEMORY_NUMA_INTERLEAVE : 0u);
+}
+
+/**
+ * @brief 将port层实际生效的提示转换回初始化选项标志
+ *
+ * @param hints PORT_MEMORY_*的组合
+ * @return CIRCULAR_BUFFER_FLAG_*的组合
+ */
+static unsigned int large_memory_flags(unsigned int hints)
+{
+    return ((hints & PORT_MEMORY_HUGE_PAGES) ? CIRCULAR_BUFFER_FLAG_HUGE_PAGES : 0u) |
+           ((hints & PORT_MEMORY_TRANSPARENT_HUGE_PAGES) ? CIRCULAR_BUFFER_FLAG_TRANSPARENT_HUGE_PAGES : 0u) |
+           ((hints & PORT_MEMORY_NUMA_BIND) ? CIRCULAR_BUFFER_FLAG_NUMA_BIND : 0u) |
+           ((hints & PORT_MEMORY_NUMA_INTERLEAVE) ? CIRCULAR_BUFFER_FLAG_NUMA_INTERLEAVE : 0u);
+}
+
+/**
+ * @brief 按初始化选项分配缓冲区内存
+ *
+ * 调用者提供的内存不清零，它可能是需要保留数据的共享内存段或持久化文件；
+ * 镜像映射和大页内存由匿名映射提供，本身已经为0，malloc分配的内存显式清零。
+ *
+ * @param cb 环形缓冲区结构体指针，size和flags已设置
+ * @param storage 调用者提供的内存，为NULL时由本函数分配
+ * @param numa_node 指定CIRCULAR_BUFFER_FLAG_NUMA_BIND时绑定的节点编号
+ * @return 成功返回true，失败返回false
+ */
+static bool allocate_buffer(circular_buffer *cb, void *storage, int numa_node)
+{
+    if (storage != NULL)
+    {
+        // 调用者提供的内存不能再做镜像映射
+        if (cb->flags & CIRCULAR_BUFFER_FLAG_MIRROR)
+        {
+            return false;
+        }
+        cb->flags |= CIRCULAR_BUFFER_FLAG_STATIC_STORAGE;
+        if (cb->flags & CIRCULAR_BUFFER_FLAG_SHARED)
+        {
+            // 共享内存段中只记录偏移，指针只在创建者进程中有效
+            cb->data_offset = (size_t)((char *)storage - (char *)cb);
+            cb->buffer = NULL;
+            return true;
+        }
+        cb->buffer = (char *)storage;
+        return true;
+    }
+    if (cb->flags & CIRCULAR_BUFFER_FLAG_MIRROR)
+    {
+        // 镜像映射的内存由匿名内存对象提供，初始内容已经为0，无需清零
+        cb->flags &= ~LARGE_MEMORY_FLAGS; // 镜像映射不支持大页和NUMA提示
+        cb->buffer = (char *)memory_mirror_alloc(cb->size);
+        return cb->buffer != NULL;
+    }
+    if (cb->flags & LARGE_MEMORY_FLAGS)
+    {
+        // 按提示分配，flags中只保留实际生效的提示；全部未生效时回退到malloc
+        unsigned int applied = 0;
+        cb->buffer = (char *)memory_large_alloc(cb->size, large_memory_hints(cb->flags), numa_node, &applied);
+        cb->flags &= ~LARGE_MEMORY_FLAGS;
+        if (cb->buffer != NULL)
+        {
+            cb->flags |= large_memory_flags(applied);
+            return true;
+        }
+    }
+    cb->buffer = (char *)malloc(cb->size); // 分配缓冲区空间
+    if (cb->buffer == NULL)
+    {
+        return false; // 分配失败返回false
+    }
+    // 库自行分配的内存保持清零，窥视或读取未写入的区域时不会暴露堆上的旧数据；
+    // 镜像映射和大页内存由匿名映射提供，本身已经为0，只有调用者提供的内存不清零
+    memset(cb->buffer, 0, cb->size); // 清零缓冲区内存
+    return true;
+}
+
+/**
+ * @brief 按分配方式释放缓冲区内存
+ *
+ * @param cb 环形缓冲区结构体指针
+ */
+static void release_buffer(circular_buffer *cb)
+{
+    if (cb->flags & CIRCULAR_BUFFER_FLAG_STATIC_STORAGE)
+    {
+        return; // 调用者提供的内存由调用者释放
+    }
+    if (cb->flags & CIRCULAR_BUFFER_FLAG_MIRROR)
+    {
+        memory_mirror_free(cb->buffer, cb->size);
+    }
+    else if (cb->flags & LARGE_MEMORY_FLAGS)
+    {
+        memory_large_free(cb->buffer, cb->size);
+    }
+    else
+    {
+        free(cb->buffer);
+    }
+}
+
+/**
+ * @brief 初始化互斥锁，共享内存中的环形缓冲区使用进程间共享的健壮锁
+ *
+ * @param cb 环形缓冲区结构体指针
+ * @param mutex 互斥锁指针
+ * @return 成功返回true，失败返回false
+ */
+static bool init_mutex(const circular_buffer *cb, mutex_t *mutex)
+{
+#if !ENABLE_LOCK
+    (void)mutex; // 关闭锁时互斥锁操作为空
+#endif
+    return is_shared(cb) ? mutex_init_shared(mutex) : mutex_init(mutex);
+}
+
+#if ENABLE_LOCK
+/**
+ * @brief 初始化条件变量，共享内存中的环形缓冲区使用进程间共享的条件变量
+ *
+ * @param cb 环形缓冲区结构体指针
+ * @param cond 条件变量指针
+ * @return 成功返回true，失败返回false
+ */
+static bool init_cond(const circular_buffer *cb, cond_t *cond)
+{
+    return is_shared(cb) ? cond_init_shared(cond) : cond_init(cond);
+}
+#endif
+
+/**
+ * @brief 销毁生产者和消费者使用的互斥锁
+ *
+ * @param cb 环形缓冲区结构体指针
+ */
+static void destroy_mutexes(circular_buffer *cb)
+{
+#if CIRCULAR_BUFFER_USE_SPLIT_LOCK
+    mutex_destroy(&cb->write_mutex);
+    mutex_destroy(&cb->read_mutex);
+#else
+    mutex_destroy(&cb->mutex);
+    (void)cb;
+#endif
+}
+
+/**
+ * @brief 初始化环形缓冲区的公共实现
+ *
+ * @param cb 环形缓冲区结构体指针
+ * @param size 缓冲区大小（必须为2的幂次）
+ * @param options 初始化选项，可以为NULL
+ * @param storage 调用者提供的内存，为NULL时按选项分配
+ * @return 成功返回true，失败返回false
+ */
+static bool init_with_storage(circular_buffer *cb, size_t size, const circular_buffer_options *options,
+                              void *storage)
+{
+    // 检查size是否为2的幂次
+    if (size == 0 || !is_power_of_two(size))
+    {
+        return false;                      // 缓冲区大小必须为2的幂次
+    }
+    cb->size = size;                       // 设置缓冲区大小
+    cb->flags = options ? options->flags : 0; // 记录初始化选项
+    cb->policy = options ? options->policy : CIRCULAR_BUFFER_POLICY_REJECT; // 记录写入策略
+    if ((unsigned int)cb->policy >= CIRCULAR_BUFFER_POLICY_COUNT)
+    {
+        return false;                      // 无效的写入策略
+    }
+    if (cb->policy == CIRCULAR_BUFFER_POLICY_OVERWRITE && (cb->flags & CIRCULAR_BUFFER_FLAG_MULTI_PRODUCER))
+    {
+        return false;                      // 覆盖旧数据需要移动start，多生产者模式下不支持
+    }
+    if ((cb->flags & CIRCULAR_BUFFER_FLAG_CONTIGUOUS_MSG) && (cb->flags & CIRCULAR_BUFFER_FLAG_MULTI_PRODUCER))
+    {
+        return false;                      // 填充长度取决于写入位置，多生产者认领时无法确定
+    }
+    atomic_init(&cb->start, 0);            // 初始化起始位置为0
+    atomic_init(&cb->end, 0);              // 初始化结束位置为0
+    atomic_init(&cb->claim, 0);            // 初始化预留游标为0
+    atomic_init(&cb->publish_wait, 0);
+#if CIRCULAR_BUFFER_SEPARATE_INDEX
+    cb->cached_start = 0;                  // 初始化生产者缓存的start
+    cb->cached_end = 0;                    // 初始化消费者缓存的end
+#endif
+    cb->reserved = 0;                      // 初始化预留长度
+    cb->peeked = 0;                        // 初始化已查看长度
+    cb->data_offset = 0;                   // 只在共享内存模式下使用
+    if (!allocate_buffer(cb, storage, options ? options->numa_node : 0))
+    {
+        return false;                      // 分配失败返回false
+    }
+    // 初始化互斥锁，防止多线程竞争
+#if CIRCULAR_BUFFER_USE_SPLIT_LOCK
+    // 读写分离锁模式下分别初始化生产者锁和消费者锁
+    if (!init_mutex(cb, &cb->write_mutex))
+    {
+        release_buffer(cb);
+        return false;
+    }
+    if (!init_mutex(cb, &cb->read_mutex))
+    {
+        mutex_destroy(&cb->write_mutex);
+        release_buffer(cb);
+        return false;
+    }
+#else
+    if (!init_mutex(cb, &cb->mutex))
+    {                       // 初始化互斥锁
+        release_buffer(cb); // 若互斥锁初始化失败，释放已分配的内存
+        return false;       // 互斥锁初始化失败返回false
+    }
+#endif
+#if ENABLE_LOCK
+    // 初始化等待数据和等待空间的条件变量
+    atomic_init(&cb->read_waiters, 0);
+    atomic_init(&cb->write_waiters, 0);
+    if (!init_cond(cb, &cb->readable))
+    {
+        destroy_mutexes(cb);
+        release_buffer(cb);
+        return false;
+    }
+    if (!init_cond(cb, &cb->writable))
+    {
+        cond_destroy(&cb->readable);
+        destroy_mutexes(cb);
+        release_buffer(cb);
+        return false;
+    }
+#else
+    atomic_init(&cb->read_wait, 0);
+    atomic_init(&cb->write_wait, 0);
+#endif
+    return true;          // 成功初始化缓冲区
+}
+
+/**
+ * @brief 初始化环形缓冲区
+ *
+ * @param cb 环形缓冲区结构体指针
+ * @param size 缓冲区大小（必须为2的幂次），全部size字节均可用于存储数据
+ * @return 成功返回true，失败返回false
+ */
+bool circular_buffer_init(circular_buffer *cb, size_t size)
+{
+    return circular_buffer_init_ex(cb, size, NULL);
+}
+
+/**
+ * @brief 按指定选项初始化环形缓冲区
+ *
+ * @param cb 环形缓冲区结构体指针
+ * @param size 缓冲区大小（必须为2的幂次），全部size字节均可用于存储数据
+ * @param options 初始化选项，为NULL时与circular_buffer_init相同
+ * @return 成功返回true，失败返回false
+ */
+bool circular_buffer_init_ex(circular_buffer *cb, size_t size, const circular_buffer_options *options)
+{
+    if (options && (options->flags & (CIRCULAR_BUFFER_FLAG_STATIC_STORAGE | CIRCULAR_BUFFER_FLAG_SHARED)))
+    {
+        return false; // 调用者提供内存时使用circular_buffer_init_static，共享内存使用circular_buffer_create_shared
+    }
+    return init_with_storage(cb, size, options, NULL);
+}
+
+/**
+ * @brief 使用调用者提供的内存初始化环形缓冲区
+ *
+ * @param cb 环形缓冲区结构体指针
+ * @param storage 缓冲区内存，至少size字节
+ * @param size 缓冲区大小（必须为2的幂次）
+ * @return 成功返回true，失败返回false
+ */
+bool circular_buffer_init_static(circular_buffer *cb, void *storage, size_t size)
+{
+    return circular_buffer_init_static_ex(cb, storage, size, NULL);
+}
+
+/**
+ * @brief 按指定选项使用调用者提供的内存初始化环形缓冲区
+ *
+ * @param cb 环形缓冲区结构体指针
+ * @param storage 缓冲区内存，至少size字节
+ * @param size 缓冲区大小（必须为2的幂次）
+ * @param options 初始化选项，为NULL时与circular_buffer_init_static相同
+ * @return 成功返回true，失败返回false
+ */
+bool circular_buffer_init_static_ex(circular_buffer *cb, void *storage, size_t size,
+                                    const circular_buffer_options *options)
+{
+    if (storage == NULL || (options && (options->flags & CIRCULAR_BUFFER_FLAG_SHARED)))
+    {
+        return false;
+    }
+    return init_with_storage(cb, size, options, storage);
+}
+
+/**
+ * @brief 在共享内存段中初始化环形缓冲区，数据区位于cb之后data_offset字节处
+ *
+ * @param cb 环形缓冲区结构体指针，位于共享内存段中
+ * @param size 缓冲区大小（必须为2的幂次）
+ * @param data_offset 数据区相对cb的偏移，数据区至少size字节
+ * @param options 初始化选项，可以为NULL
+ * @return 成功返回true，失败返回false
+ */
+bool circular_buffer_init_shared(circular_buffer *cb, size_t size, size_t data_offset,
+                                 const circular_buffer_options *options)
+{
+    circular_buffer_options shared = {.policy = CIRCULAR_BUFFER_POLICY_REJECT};
+    if (options)
+    {
+        shared = *options;
+    }
+    if (shared.flags & CIRCULAR_BUFFER_FLAG_MULTI_PRODUCER)
+    {
+        return false; // 生产者在认领和发布之间退出会使后续发布永远等待，跨进程时不支持
+    }
+    // 内存由共享内存段提供，大页和NUMA提示不适用
+    shared.flags = (shared.flags & ~LARGE_MEMORY_FLAGS) | CIRCULAR_BUFFER_FLAG_SHARED;
+    return init_with_storage(cb, size, &shared, (char *)cb + data_offset);
+}
+
+/**
+ * @brief 重新打开共享内存段中已有的环形缓冲区，保留start/end和数据
+ *
+ * @param cb 环形缓冲区结构体指针，位于共享内存段中
+ * @param data_offset 数据区相对cb的偏移
+ * @return 成功返回true，索引不一致时返回false
+ */
+bool circular_buffer_reopen_shared(circular_buffer *cb, size_t data_offset)
+{
+    size_t start = atomic_load_explicit(&cb->start, memory_order_relaxed);
+    size_t end = atomic_load_explicit(&cb->end, memory_order_relaxed);
+    if (end - start > cb->size)
+    {
+        return false; // 索引已经损坏
+    }
+    // 锁、等待标志和预留状态属于上一次打开的进程，全部重新初始化；
+    // 上次写了一半的数据位于end之后，从未发布，直接丢弃
+    circular_buffer_options options = {
+        .flags = cb->flags & ~(CIRCULAR_BUFFER_FLAG_STATIC_STORAGE | CIRCULAR_BUFFER_FLAG_SHARED),
+        .policy = cb->policy,
+    };
+    if (!circular_buffer_init_shared(cb, cb->size, data_offset, &options))
+    {
+        return false;
+    }
+    atomic_store_explicit(&cb->start, start, memory_order_relaxed);
+    atomic_store_explicit(&cb->end, end, memory_order_relaxed);
+    atomic_store_explicit(&cb->claim, end, memory_order_relaxed);
+#if CIRCULAR_BUFFER_SEPARATE_INDEX
+    cb->cached_start = start;
+    cb->cached_end = end;
+#endif
+    return true;
+}
+
+/**
+ * @brief 释放环形缓冲区资源
+ *
+ * @param cb 环形缓冲区结构体指针
+ */
+void circular_buffer_free(circular_buffer *cb)
+{
+    if (cb->buffer)
+    {
+        release_buffer(cb);    // 释放缓冲区内存
+        cb->buffer = NULL;     // 将指针置空，避免野指针
+    }
+#if ENABLE_LOCK
+    cond_destroy(&cb->readable); // 销毁条件变量
+    cond_destroy(&cb->writable);
+#endif
+    destroy_mutexes(cb);       // 销毁互斥锁
+    cb->size = 0;              // 重置缓冲区大小
+    atomic_store_explicit(&cb->start, 0, memory_order_relaxed); // 重置起始位置
+    atomic_store_explicit(&cb->end, 0, memory_order_relaxed);   // 重置结束位置
+    atomic_store_explicit(&cb->claim, 0, memory_order_relaxed); // 重置预留游标
+#if CIRCULAR_BUFFER_SEPARATE_INDEX
+    cb->cached_start = 0;
+    cb->cached_end = 0;
+#endif
+    cb->reserved = 0;
+    cb->peeked = 0;
+}
+
+/**
+ * @brief 拒绝新数据策略的写入：剩余空间不足时不写入任何数据
+ *
+ * @param cb 环形缓冲区结构体指针
+ * @param data 写入数据的指针
+ * @param length 写入数据的长度（不为0）
+ * @return 成功返回true，空间不足返回false
+ */
+static bool write_reject(circular_buffer *cb, const char *data, size_t length)
+{
+    DEBUG_PRINT("尝试获取写锁\n");
+    mutex_lock(PRODUCER_MUTEX(cb)); // 加锁，防止多个生产者同时访问缓冲区
+    DEBUG_PRINT("已获取写锁\n");
+
+    // 生产者是end的唯一修改者，读取自己的索引使用relaxed即可
+    // 读取消费者的start使用acquire，与消费者释放start时的release配对，
+    // 保证消费者在释放空间之前对这段空间的读取已经完成，写入不会覆盖尚未读走的数据
+    // 索引分离布局下优先使用本地缓存的start，见producer_load_start
+    size_t end = atomic_load_explicit(&cb->end, memory_order_relaxed);
+    size_t start = producer_load_start(cb, end, length);
+
+    // 计算缓冲区内的有效数据长度
+    // start和end是自由增长的计数器，只在访问缓冲区时才通过掩码映射到0到size-1的位置，
+    // 两者之差即为有效数据长度，范围是0到size，因此全部size个字节都可以使用，
+    // 无需像掩码索引那样空出一个位置来区分满和空
+    // 无符号整数的回绕保证end溢出后差值依然正确
+    // 例如，假设缓冲区大小为8，则掩码为0111
+    // 比如end=10, start=2，则current_length = 10 - 2 = 8，缓冲区已满
+    // 图示:
+    //       end & 7 = 2
+    //       start & 7 = 2
+    //        |
+    // [X][X][X][X][X][X][X][X]
+    // current_length = end - start
+    //                = 10 - 2
+    //                = 8
+    size_t current_length = end - start;
+    // 计算缓冲区剩余空间大小
+    // 若缓冲区大小为8，current_length = 5，则available_space = 8 - 5 = 3
+    // 图示:
+    // 缓冲区大小为8
+    // start
+    //  |
+    // [ ][ ][X][X][X][X][X][ ]
+    //                    |
+    //                   end
+    // available_space = size - current_length
+    //                 = 8 - 5
+    //                 = 3
+    size_t available_space = cb->size - current_length;
+
+    // 如果剩余空间不足以写入新数据
+    if (available_space < length)
+    {
+        DEBUG_PRINT("缓冲区空间不足，无法写入\n");
+        mutex_unlock(PRODUCER_MUTEX(cb)); // 解锁
+        return false;             // 缓冲区空间不足，丢弃新数据
+    }
+
+    // 按环绕点拆分为最多两段进行批量拷贝，写入位置为end & (size - 1)
+    copy_to_buffer(cb, end & (cb->size - 1), data, length);
+    // 一次性更新结束位置，end自由增长，不做掩码
+    // 假设end = 6, length = 4, size = 8, end = 6 + 4 = 10，对应位置10 & 7 = 2
+    // 图示:
+    // 写入数据前
+    //  start
+    //    |
+    // [ ][ ][ ][ ][ ][ ][ ][ ]
+    //                    |
+    //                   end
+    // 写入数据后
+    //  start
+    //    |
+    // [X][X][ ][ ][ ][ ][X][X]
+    //        |
+    //       end
+    // 使用release发布end，保证消费者通过acquire看到新的end时，数据已经完整写入
+    atomic_store_explicit(&cb->end, end + length, memory_order_release);
+
+    DEBUG_PRINT("写入完成，释放写锁\n");
+    producer_unlock_notify(cb); // 解锁，有读取端在等待时唤醒
+    return true;                // 数据写入成功
+}
+
+#if ENABLE_LOCK
+/**
+ * @brief 覆盖旧数据策略下为length个字节腾出空间，调用者需持有生产者锁
+ *
+ * 剩余空间不足时由写入端移动start丢弃最早的数据，移动期间持有消费者使用的锁，与读取端不会交错。
+ *
+ * @param cb 环形缓冲区结构体指针
+ * @param end 生产者当前的end
+ * @param length 需要的空间（不超过size）
+ */
+static void overwrite_make_room(circular_buffer *cb, size_t end, size_t length)
+{
+    // 与write_reject相同的剩余空间计算
+    size_t start = producer_load_start(cb, end, length);
+    size_t available_space = cb->size - (end - start);
+
+    if (available_space < length)
+    {
+#if CIRCULAR_BUFFER_USE_SPLIT_LOCK
+        // 读写分离锁模式下移动start还需要持有消费者锁，等待正在进行的读取完成；
+        // 加锁顺序固定为先生产者锁后消费者锁，消费者持有消费者锁时从不获取生产者锁
+        mutex_lock(CONSUMER_MUTEX(cb));
+        start = atomic_load_explicit(&cb->start, memory_order_acquire); // 等待期间消费者可能已经读走了数据
+        available_space = cb->size - (end - start);
+        if (available_space < length)
+        {
+#endif
+        // 如果新数据长度大于可用空间，计算需要覆盖的字节数
+        // 若length = 4，则excess = 4 - 3 = 1
+        size_t excess = length - available_space;
+        // 更新起始位置，将起始位置向前移动excess个位置
+        // 假设start = 2, excess = 1, size = 8
+        // new_start = 2 + 1 = 3
+        start += excess;
+        atomic_store_explicit(&cb->start, start, memory_order_release);
+#if CIRCULAR_BUFFER_SEPARATE_INDEX
+        // 走到这里时producer_load_start已经刷新过start，缓存同步为新的start；
+        // 消费者缓存的end可能落后于新的start，将其重置为start，迫使消费者重新读取end
+        cb->cached_start = start;
+        cb->cached_end = start;
+#endif
+#if CIRCULAR_BUFFER_USE_SPLIT_LOCK
+        }
+        mutex_unlock(CONSUMER_MUTEX(cb));
+#endif
+    }
+}
+
+/**
+ * @brief 覆盖旧数据策略的写入：剩余空间不足时丢弃最早的数据
+ *
+ * @param cb 环形缓冲区结构体指针
+ * @param data 写入数据的指针
+ * @param length 写入数据的长度（不为0）
+ * @return 总是返回true
+ */
+static bool write_overwrite(circular_buffer *cb, const char *data, size_t length)
+{
+    // 若新数据本身超过缓冲区容量，只有最后size个字节会被保留，
+    // 直接跳过前面的部分，保证单次拷贝不超过缓冲区大小
+    if (length > cb->size)
+    {
+        data += length - cb->size;
+        length = cb->size;
+    }
+
+    mutex_lock(PRODUCER_MUTEX(cb)); // 加锁，防止多个生产者同时访问缓冲区
+    size_t end = atomic_load_explicit(&cb->end, memory_order_relaxed);
+    overwrite_make_room(cb, end, length);
+    copy_to_buffer(cb, end & (cb->size - 1), data, length);
+    atomic_store_explicit(&cb->end, end + length, memory_order_release);
+    producer_unlock_notify(cb); // 解锁，有读取端在等待时唤醒
+    return true;
+}
+#else
+/**
+ * @brief 无锁模式下覆盖旧数据策略的写入：写入端从不等待，也不访问start
+ *
+ * 写入端移动start会与并发的读取端竞争，因此无锁模式下写入端只推进自己的索引，
+ * 由读取端自行检测是否被套圈（类似顺序锁seqlock）：
+ * 1. 先将claim设置为本次写入的结束位置，声明[claim - size, claim)之前的数据即将失效
+ * 2. release屏障保证claim的更新先于数据写入对读取端可见
+ * 3. 拷贝数据，再以release发布end
+ * 读取端拷贝数据后经acquire屏障读取claim，若claim - start超过size，
+ * 说明拷贝期间这段数据可能已被覆盖，丢弃结果并跳到最早的有效数据重新读取，见overwrite_read。
+ *
+ * 图示（size = 8，end = 8，写入4个字节）:
+ * start            end/claim              start      end   claim
+ *   |                |                      |          |     |
+ *  [0][1][2][3][4][5][6][7]      ->       [8][9][A][B][4][5][6][7]
+ * claim = 12，[0, 4)失效，最早的有效数据从4开始
+ *
+ * @param cb 环形缓冲区结构体指针
+ * @param data 写入数据的指针
+ * @param length 写入数据的长度（不为0）
+ * @return 总是返回true
+ */
+static bool write_overwrite(circular_buffer *cb, const char *data, size_t length)
+{
+    // 若新数据本身超过缓冲区容量，只有最后size个字节会被保留
+    if (length > cb->size)
+    {
+        data += length - cb->size;
+        length = cb->size;
+    }
+    size_t end = atomic_load_explicit(&cb->end, memory_order_relaxed);
+    atomic_store_explicit(&cb->claim, end + length, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    copy_to_buffer(cb, end & (cb->size - 1), data, length);
+    atomic_store_explicit(&cb->end, end + length, memory_order_release);
+    notify_readable(cb); // 有读取端在等待时唤醒
+    return true;
+}
+
+/**
+ * @brief 无锁覆盖模式下检查从start开始的数据在读取期间是否被覆盖
+ *
+ * 调用前必须已经完成对数据的读取：acquire屏障与写入端的release屏障配对，
+ * 只要读到了写入端在声明claim之后写入的任何字节，这里就一定能看到新的claim。
+ *
+ * @param cb 环形缓冲区结构体指针
+ * @param start 已读取数据的起始位置
+ * @param claim 返回读取到的claim
+ * @return 数据完整返回true，可能已被覆盖返回false
+ */
+static bool overwrite_validate(circular_buffer *cb, size_t start, size_t *claim)
+{
+    atomic_thread_fence(memory_order_acquire);
+    *claim = atomic_load_explicit(&cb->claim, memory_order_relaxed);
+    // claim可能落后于start（写入端尚未发生覆盖），按有符号差值比较
+    return (ptrdiff_t)(*claim - start) <= (ptrdiff_t)cb->size;
+}
+
+/**
+ * @brief 无锁覆盖模式下的读取，被套圈时重新同步到最早的有效数据
+ *
+ * @param cb 环形缓冲区结构体指针
+ * @param data 读取数据的指针
+ * @param length 请求读取的长度
+ * @param partial true时数据不足则读取已有的全部数据，false时数据不足直接失败
+ * @return 实际读取的字节数，为0表示没有读取到数据
+ */
+static size_t overwrite_read(circular_buffer *cb, char *data, size_t length, bool partial)
+{
+    size_t start = atomic_load_explicit(&cb->start, memory_order_relaxed);
+    size_t original = start;
+    for (;;)
+    {
+        size_t end = atomic_load_explicit(&cb->end, memory_order_acquire);
+        if (end - start > cb->size)
+        {
+            start = end - cb->size; // 已被套圈，跳到最早的有效数据
+        }
+        size_t current_length = end - start;
+        if (current_length < length && (!partial || current_length == 0))
+        {
+            if (start != original)
+            {
+                atomic_store_explicit(&cb->start, start, memory_order_release); // 记录重新同步后的位置
+            }
+            return 0; // 数据不足
+        }
+        size_t amount = (current_length < length) ? current_length : length;
+        copy_from_buffer(cb, start & (cb->size - 1), data, amount);
+        size_t claim;
+        if (overwrite_validate(cb, start, &claim))
+        {
+            atomic_store_explicit(&cb->start, start + amount, memory_order_release);
+            return amount;
+        }
+        // 拷贝期间数据被覆盖，丢弃本次结果，从写入端声明的最早有效位置重新读取
+        start = claim - cb->size;
+    }
+}
+#endif
+
+/**
+ * @brief 截断新数据策略的写入：只写入剩余空间能容纳的前缀
+ *
+ * @param cb 环形缓冲区结构体指针
+ * @param data 写入数据的指针
+ * @param length 写入数据的长度（不为0）
+ * @return 写入至少一个字节返回true，缓冲区已满返回false
+ */
+static bool write_truncate(circular_buffer *cb, const char *data, size_t length)
+{
+    return circular_buffer_write_some(cb, data, length) > 0;
+}
+
+/**
+ * @brief 多生产者模式下拒绝新数据策略的写入
+ *
+ * 不加锁，认领空间后并行拷贝，按认领顺序发布。
+ *
+ * @param cb 环形缓冲区结构体指针
+ * @param data 写入数据的指针
+ * @param length 写入数据的长度（不为0）
+ * @return 成功返回true，空间不足返回false
+ */
+static bool write_multi_producer_reject(circular_buffer *cb, const char *data, size_t length)
+{
+    size_t position;
+    if (multi_producer_claim(cb, length, false, &position) == 0)
+    {
+        return false; // 缓冲区空间不足，丢弃新数据
+    }
+    multi_producer_publish(cb, position, data, length);
+    return true;
+}
+
+/**
+ * @brief 多生产者模式下截断新数据策略的写入
+ *
+ * @param cb 环形缓冲区结构体指针
+ * @param data 写入数据的指针
+ * @param length 写入数据的长度（不为0）
+ * @return 写入至少一个字节返回true，缓冲区已满返回false
+ */
+static bool write_multi_producer_truncate(circular_buffer *cb, const char *data, size_t length)
+{
+    size_t position;
+    length = multi_producer_claim(cb, length, true, &position);
+    if (length == 0)
+    {
+        return false; // 缓冲区已满
+    }
+    multi_producer_publish(cb, position, data, length);
+    return true;
+}
+
+/**
+ * @brief 按[是否多生产者][写入策略]索引的写入函数表
+ *
+ * 策略和模式在初始化后不再变化，circular_buffer_write通过查表直接调用对应的写入函数，
+ * 热路径上只有一次间接调用，没有策略判断的分支。
+ * 多生产者模式不支持覆盖旧数据，对应位置为NULL，初始化时已经拒绝这种组合。
+ */
+static bool (*const write_functions[2][CIRCULAR_BUFFER_POLICY_COUNT])(circular_buffer *, const char *, size_t) = {
+    {write_reject, write_overwrite, write_truncate},
+    {write_multi_producer_reject, NULL, write_multi_producer_truncate},
+};
+
+/**
+ * @brief 向环形缓冲区写入数据
+ *
+ * @param cb 环形缓冲区结构体指针
+ * @param data 写入数据的指针
+ * @param length 写入数据的长度
+ * @return 成功返回true，失败返回false
+ */
+bool circular_buffer_write(circular_buffer *cb, const char *data, size_t length)
+{
+    if (length == 0)
+    {
+        return false; // 写入数据长度不能为0
+    }
+    bool multi_producer = (cb->flags & CIRCULAR_BUFFER_FLAG_MULTI_PRODUCER) != 0;
+    return write_functions[multi_producer][cb->policy](cb, data, length);
+}
+
+/**
+ * @brief 从环形缓冲区读取数据
+ *
+ * @param cb 环形缓冲区结构体指针
+ * @param data 读取数据的指针
+ * @param length 读取数据的长度
+ * @return 成功返回true，失败返回false
+ */
+bool circular_buffer_read(circular_buffer *cb, char *data, size_t length)
+{
+    if (length == 0)
+    {
+        return false; // 读取数据长度不能为0
+    }
+#if !ENABLE_LOCK
+    if (cb->policy == CIRCULAR_BUFFER_POLICY_OVERWRITE)
+    {
+        return overwrite_read(cb, data, length, false) == length;
+    }
+#endif
+
+    DEBUG_PRINT("尝试获取读锁\n");
+    mutex_lock(CONSUMER_MUTEX(cb)); // 加锁，防止多个消费者同时访问缓冲区
+    DEBUG_PRINT("已获取读锁\n");
+
+    // 消费者是start的唯一修改者，读取自己的索引使用relaxed即可
+    // 读取生产者的end使用acquire，与生产者发布end时的release配对，
+    // 保证看到新的end时，对应的数据已经对当前线程可见
+    // 索引分离布局下优先使用本地缓存的end，见consumer_load_end
+    size_t start = atomic_load_explicit(&cb->start, memory_order_relaxed);
+    size_t end = consumer_load_end(cb, start, length);
+
+    // 计算缓冲区内的有效数据长度
+    // start和end自由增长，两者之差即为有效数据长度
+    // 若end=6, start=2, size=8, current_length = 6 - 2 = 4
+    // 图示:
+    // start
+    //  |
+    // [ ][ ][X][X][X][X][ ][ ]
+    //              |
+    //             end
+    // current_length = end - start
+    //                = 6 - 2
+    //                = 4
+    size_t current_length = end - start;
+    // 如果有效数据长度小于请求的读取长度，则无法读取
+    if (current_length < length)
+    {
+        DEBUG_PRINT("缓冲区数据不足，无法读取\n");
+        mutex_unlock(CONSUMER_MUTEX(cb)); // 解锁
+        return false;             // 缓冲区数据不足
+    }
+
+    // 按环绕点拆分为最多两段进行批量拷贝
+    copy_from_buffer(cb, start & (cb->size - 1), data, length);
+    // 一次性更新起始位置，start自由增长，不做掩码
+    // 假设start = 6, length = 4, size = 8, start = 6 + 4 = 10，对应位置10 & 7 = 2
+    // 使用release释放start，保证生产者通过acquire看到新的start时，这段空间的读取已经完成
+    atomic_store_explicit(&cb->start, start + length, memory_order_release);
+
+    DEBUG_PRINT("读取完成，释放读锁\n");
+    consumer_unlock_notify(cb); // 解锁，有写入端在等待时唤醒
+    return true;                // 数据读取成功
+}
+
+/**
+ * @brief 向环形缓冲区写入尽可能多的数据
+ *
+ * @param cb 环形缓冲区结构体指针
+ * @param data 写入数据的指针
+ * @param length 请求写入的最大长度
+ * @return 实际写入的字节数，缓冲区已满时返回0
+ */
+size_t circular_buffer_write_some(circular_buffer *cb, const char *data, size_t length)
+{
+    if (cb->flags & CIRCULAR_BUFFER_FLAG_MULTI_PRODUCER)
+    {
+        // 多生产者模式：认领剩余空间能容纳的部分
+        size_t position;
+        length = multi_producer_claim(cb, length, true, &position);
+        if (length > 0)
+        {
+            multi_producer_publish(cb, position, data, length);
+        }
+        return length;
+    }
+
+    mutex_lock(PRODUCER_MUTEX(cb)); // 加锁，防止多个生产者同时访问缓冲区
+
+    // 以length作为需要的空间刷新缓存的start，缓存视图不足时会重新读取共享的start
+    size_t end = atomic_load_explicit(&cb->end, memory_order_relaxed);
+    size_t start = producer_load_start(cb, end, length);
+    size_t available_space = cb->size - (end - start);
+    if (length > available_space)
+    {
+        length = available_space; // 只写入剩余空间能容纳的部分
+    }
+
+    if (length == 0)
+    {
+        mutex_unlock(PRODUCER_MUTEX(cb)); // 缓冲区已满，直接解锁
+        return 0;
+    }
+    copy_to_buffer(cb, end & (cb->size - 1), data, length);
+    atomic_store_explicit(&cb->end, end + length, memory_order_release);
+    producer_unlock_notify(cb); // 解锁，有读取端在等待时唤醒
+    return length;
+}
+
+/**
+ * @brief 从环形缓冲区读取尽可能多的数据
+ *
+ * @param cb 环形缓冲区结构体指针
+ * @param data 读取数据的指针
+ * @param length 请求读取的最大长度
+ * @return 实际读取的字节数，缓冲区为空时返回0
+ */
+size_t circular_buffer_read_some(circular_buffer *cb, char *data, size_t length)
+{
+#if !ENABLE_LOCK
+    if (cb->policy == CIRCULAR_BUFFER_POLICY_OVERWRITE)
+    {
+        return overwrite_read(cb, data, length, true);
+    }
+#endif
+    mutex_lock(CONSUMER_MUTEX(cb)); // 加锁，防止多个消费者同时访问缓冲区
+
+    // 以length作为需要的数据长度刷新缓存的end，缓存视图不足时会重新读取共享的end
+    size_t start = atomic_load_explicit(&cb->start, memory_order_relaxed);
+    size_t end = consumer_load_end(cb, start, length);
+    size_t current_length = end - start;
+    if (length > current_length)
+    {
+        length = current_length; // 只读取已有的部分
+    }
+
+    if (length == 0)
+    {
+        mutex_unlock(CONSUMER_MUTEX(cb)); // 缓冲区为空，直接解锁
+        return 0;
+    }
+    copy_from_buffer(cb, start & (cb->size - 1), data, length);
+    atomic_store_explicit(&cb->start, start + length, memory_order_release);
+    consumer_unlock_notify(cb); // 解锁，有写入端在等待时唤醒
+    return length;
+}
+
 /**
- * @brief 检查是否为2的幂
+ * @brief 向环形缓冲区写入数据，空间不足时等待，最多等待timeout_ms毫秒
  *
- * @param size 待检查的大小
- * @return 是2的幂返回true，否则返回false
+ * @param cb 环形缓冲区结构体指针
+ * @param data 写入数据的指针
+ * @param length 写入数据的长度，不能超过缓冲区大小
+ * @param timeout_ms 超时时间（毫秒），0表示不等待，CIRCULAR_BUFFER_WAIT_FOREVER表示无限等待
+ * @return 成功返回true，超时或参数无效返回false
  */
-static bool is_power_of_two(size_t size)
+bool circular_buffer_write_timed(circular_buffer *cb, const char *data, size_t length, uint32_t timeout_ms)
 {
-    // 检查size是否为2的幂次
-    // 2的幂次在二进制表示中只有一个1，其余位都是0
-    // 例如，4的二进制表示是100，8的二进制表示是1000
+    if (cb->policy == CIRCULAR_BUFFER_POLICY_OVERWRITE)
+    {
+        // 覆盖旧数据策略下写入从不因空间不足而失败，无需等待
+        return circular_buffer_write(cb, data, length);
+    }
+    if (length == 0 || length > cb->size)
+    {
+        return false; // 长度为0或超过缓冲区大小时永远无法写入
+    }
+    uint64_t deadline = time_now_ms() + timeout_ms;
 
-    // 首先检查size是否不为0
-    // 如果size为0，则不是2的幂次，因为2的任何幂都不可能为0
-    // 所以我们需要确保size不为0
+#if ENABLE_LOCK
+    mutex_lock(PRODUCER_MUTEX(cb)); // 加锁，等待期间由条件变量释放
+    bool timed_out = false;
+    if (cb->flags & CIRCULAR_BUFFER_FLAG_MULTI_PRODUCER)
+    {
+        // 多生产者模式：持锁只为与读取端的通知串行化，认领成功后解锁再拷贝和发布
+        size_t position;
+        while (multi_producer_claim(cb, length, false, &position) == 0)
+        {
+            uint32_t wait_ms = remaining_ms(deadline, timeout_ms);
+            if (timed_out || wait_ms == 0)
+            {
+                mutex_unlock(PRODUCER_MUTEX(cb)); // 解锁
+                return false;                     // 等待超时
+            }
+            // 登记后经全序屏障重新尝试认领，与读取端释放空间后的屏障配对
+            atomic_fetch_add_explicit(&cb->write_waiters, 1, memory_order_relaxed);
+            atomic_thread_fence(memory_order_seq_cst);
+            if (multi_producer_claim(cb, length, false, &position) != 0)
+            {
+                atomic_fetch_sub_explicit(&cb->write_waiters, 1, memory_order_relaxed);
+                break; // 登记期间空间已经足够
+            }
+            timed_out = !cond_wait(&cb->writable, PRODUCER_MUTEX(cb), wait_ms);
+            atomic_fetch_sub_explicit(&cb->write_waiters, 1, memory_order_relaxed);
+        }
+        mutex_unlock(PRODUCER_MUTEX(cb)); // 解锁
+        multi_producer_publish(cb, position, data, length);
+        return true;
+    }
+    size_t end = atomic_load_explicit(&cb->end, memory_order_relaxed);
+    for (;;)
+    {
+        size_t start = producer_load_start(cb, end, length);
+        if (cb->size - (end - start) >= length)
+        {
+            break; // 空间足够
+        }
+        uint32_t wait_ms = remaining_ms(deadline, timeout_ms);
+        if (timed_out || wait_ms == 0)
+        {
+            mutex_unlock(PRODUCER_MUTEX(cb)); // 解锁
+            return false;                     // 等待超时
+        }
+        // 登记为等待者，读取端释放空间后才会发出通知
+        // 读写分离锁模式下读取端不持有生产者锁释放空间，登记后经全序屏障重新检查start，
+        // 与notify_writable_unlocked中的屏障配对，避免丢失唤醒
+        atomic_fetch_add_explicit(&cb->write_waiters, 1, memory_order_relaxed);
+        atomic_thread_fence(memory_order_seq_cst);
+        start = atomic_load_explicit(&cb->start, memory_order_relaxed);
+        if (cb->size - (end - start) >= length)
+        {
+            atomic_fetch_sub_explicit(&cb->write_waiters, 1, memory_order_relaxed);
+            continue; // 登记期间空间已经足够，重新读取
+        }
+        timed_out = !cond_wait(&cb->writable, PRODUCER_MUTEX(cb), wait_ms);
+        atomic_fetch_sub_explicit(&cb->write_waiters, 1, memory_order_relaxed);
+    }
 
-    // 现在考虑size为非0的情况
-    // 利用位操作来检查size是否是2的幂次
-    // 具体来说，我们使用表达式 (size & (size - 1)) == 0
-    // 其原理如下：
+    copy_to_buffer(cb, end & (cb->size - 1), data, length);
+    atomic_store_explicit(&cb->end, end + length, memory_order_release);
+    producer_unlock_notify(cb); // 解锁，有读取端在等待时唤醒
+    return true;
+#else
+    // 无锁模式下先自旋重试，自旋次数用完后在futex等待字上休眠
+    // 截断策略下也要等到全部数据都能写入，因此重试时始终按拒绝策略写入
+    bool multi_producer = (cb->flags & CIRCULAR_BUFFER_FLAG_MULTI_PRODUCER) != 0;
+    bool (*write_whole)(circular_buffer *, const char *, size_t) =
+        write_functions[multi_producer][CIRCULAR_BUFFER_POLICY_REJECT];
+    unsigned int spins = 0;
+    bool timed_out = false;
+    while (!write_whole(cb, data, length))
+    {
+        if (timeout_ms != 0 && spins < CIRCULAR_BUFFER_SPIN_COUNT)
+        {
+            spins++;
+            continue;
+        }
+        uint32_t wait_ms = remaining_ms(deadline, timeout_ms);
+        if (timed_out || wait_ms == 0)
+        {
+            return false; // 等待超时
+        }
+        // 先登记等待标志，再重新检查剩余空间，与notify_writable中的屏障配对
+        atomic_store_explicit(&cb->write_wait, 1, memory_order_relaxed);
+        atomic_thread_fence(memory_order_seq_cst);
+        // 多生产者模式下已认领但尚未发布的空间同样不可用，以claim为准
+        size_t end = (cb->flags & CIRCULAR_BUFFER_FLAG_MULTI_PRODUCER)
+                         ? atomic_load_explicit(&cb->claim, memory_order_relaxed)
+                         : atomic_load_explicit(&cb->end, memory_order_relaxed);
+        size_t start = atomic_load_explicit(&cb->start, memory_order_relaxed);
+        if (cb->size - (end - start) >= length)
+        {
+            continue; // 登记期间空间已经足够，直接重试
+        }
+        timed_out = !futex_wait(&cb->write_wait, 1, wait_ms, is_shared(cb));
+    }
+    return true;
+#endif
+}
 
-    // 对于一个数size，如果它是2的幂次，例如4 (100) 或8 (1000)
-    // 它的二进制表示中只有一个1，其余位都是0
+/**
+ * @brief 从环形缓冲区读取数据，数据不足时等待，最多等待timeout_ms毫秒
+ *
+ * @param cb 环形缓冲区结构体指针
+ * @param data 读取数据的指针
+ * @param length 读取数据的长度，不能超过缓冲区大小
+ * @param timeout_ms 超时时间（毫秒），0表示不等待，CIRCULAR_BUFFER_WAIT_FOREVER表示无限等待
+ * @return 成功返回true，超时或参数无效返回false
+ */
+bool circular_buffer_read_timed(circular_buffer *cb, char *data, size_t length, uint32_t timeout_ms)
+{
+    if (length == 0 || length > cb->size)
+    {
+        return false; // 长度为0或超过缓冲区大小时永远无法读取
+    }
+    uint64_t deadline = time_now_ms() + timeout_ms;
 
-    // 当我们从size中减去1时
-    // 例如，4 - 1 = 3，二进制表示为100 - 1 = 011
-    // 或者8 - 1 = 7，二进制表示为1000 - 1 = 0111
+#if ENABLE_LOCK
+    mutex_lock(CONSUMER_MUTEX(cb)); // 加锁，等待期间由条件变量释放
+    bool timed_out = false;
+    size_t start;
+    for (;;)
+    {
+        // 覆盖旧数据策略下写入端可能移动start，每次检查前重新读取
+        start = atomic_load_explicit(&cb->start, memory_order_relaxed);
+        size_t end = consumer_load_end(cb, start, length);
+        if (end - start >= length)
+        {
+            break; // 数据足够
+        }
+        uint32_t wait_ms = remaining_ms(deadline, timeout_ms);
+        if (timed_out || wait_ms == 0)
+        {
+            mutex_unlock(CONSUMER_MUTEX(cb)); // 解锁
+            return false;                     // 等待超时
+        }
+        // 登记为等待者，写入端发布数据后才会发出通知
+        // 多生产者模式和读写分离锁模式下写入端不持有消费者锁发布，登记后经全序屏障重新检查end，
+        // 与notify_readable_unlocked中的屏障配对，避免丢失唤醒
+        atomic_fetch_add_explicit(&cb->read_waiters, 1, memory_order_relaxed);
+        atomic_thread_fence(memory_order_seq_cst);
+        if (atomic_load_explicit(&cb->end, memory_order_relaxed) - start >= length)
+        {
+            atomic_fetch_sub_explicit(&cb->read_waiters, 1, memory_order_relaxed);
+            continue; // 登记期间数据已经到达，重新读取
+        }
+        timed_out = !cond_wait(&cb->readable, CONSUMER_MUTEX(cb), wait_ms);
+        atomic_fetch_sub_explicit(&cb->read_waiters, 1, memory_order_relaxed);
+    }
 
-    // 减1操作会将size的二进制表示中的最低位的1变为0
-    // 并将这个1右边的所有0变为1
+    copy_from_buffer(cb, start & (cb->size - 1), data, length);
+    atomic_store_explicit(&cb->start, start + length, memory_order_release);
+    consumer_unlock_notify(cb); // 解锁，有写入端在等待时唤醒
+    return true;
+#else
+    // 无锁模式下先自旋重试，自旋次数用完后在futex等待字上休眠
+    unsigned int spins = 0;
+    bool timed_out = false;
+    while (!circular_buffer_read(cb, data, length))
+    {
+        if (timeout_ms != 0 && spins < CIRCULAR_BUFFER_SPIN_COUNT)
+        {
+            spins++;
+            continue;
+        }
+        uint32_t wait_ms = remaining_ms(deadline, timeout_ms);
+        if (timed_out || wait_ms == 0)
+        {
+            return false; // 等待超时
+        }
+        // 先登记等待标志，再重新检查数据，与notify_readable中的屏障配对
+        atomic_store_explicit(&cb->read_wait, 1, memory_order_relaxed);
+        atomic_thread_fence(memory_order_seq_cst);
+        size_t start = atomic_load_explicit(&cb->start, memory_order_relaxed);
+        size_t end = atomic_load_explicit(&cb->end, memory_order_relaxed);
+        if (end - start >= length)
+        {
+            continue; // 登记期间数据已经到达，直接重试
+        }
+        timed_out = !futex_wait(&cb->read_wait, 1, wait_ms, is_shared(cb));
+    }
+    return true;
+#endif
+}
 
-    // 现在，考虑按位与操作 size & (size - 1)
-    // 对于4：100 & 011 = 000
-    // 对于8：1000 & 0111 = 0000
+/**
+ * @brief 在环形缓冲区内预留一段可写空间（零拷贝写入）
+ *
+ * @param cb 环形缓冲区结构体指针
+ * @param length 需要预留的长度
+ * @param spans 返回的可写内存段
+ * @return 成功返回true，长度为0或剩余空间不足返回false
+ */
+bool circular_buffer_write_reserve(circular_buffer *cb, size_t length, circular_buffer_spans *spans)
+{
+    if (length == 0)
+    {
+        return false; // 预留长度不能为0
+    }
+    if (cb->flags & CIRCULAR_BUFFER_FLAG_MULTI_PRODUCER)
+    {
+        return false; // 多生产者模式下写入端不加锁，无法独占end之后的空间
+    }
 
-    // 可以看到，如果size是2的幂次，size & (size - 1) 的结果必然是0
-    // 因为在减去1之后，最低位的1被清除了，且没有其他相同的位会保留1
+    mutex_lock(PRODUCER_MUTEX(cb)); // 加锁，成功时在circular_buffer_write_commit中解锁
 
-    // 如果size不是2的幂次，例如5 (101)
-    // 5 - 1 = 4，二进制表示为101 - 1 = 100
-    // size & (size - 1) = 101 & 100 = 100
-    // 结果不为0，因为原来的最低位的1并没有被清除
+    // 与circular_buffer_write相同的剩余空间计算，预留不支持覆盖旧数据
+    size_t end = atomic_load_explicit(&cb->end, memory_order_relaxed);
+    size_t start = producer_load_start(cb, end, length);
+    size_t available_space = cb->size - (end - start);
+    if (available_space < length)
+    {
+        DEBUG_PRINT("缓冲区空间不足，无法预留\n");
+        mutex_unlock(PRODUCER_MUTEX(cb)); // 解锁
+        return false;             // 缓冲区空间不足
+    }
 
-    // 因此，通过检查 (size & (size - 1)) == 0
-    // 我们可以判断size是否是2的幂次
-    return (size != 0) && ((size & (size - 1)) == 0);
+    // 预留的空间位于end之后，在提交之前对消费者不可见
+    fill_spans(cb, end & (cb->size - 1), length, spans);
+    cb->reserved = length;
+    return true;
 }
 
-
 /**
- * @brief 初始化环形缓冲区
+ * @brief 按写入策略预留写入空间（零拷贝写入）
  *
  * @param cb 环形缓冲区结构体指针
- * @param size 缓冲区大小（必须为2的幂次），真正可以用于存储数据的长度为 size-1
- * @return 成功返回true，失败返回false
+ * @param length 请求预留的长度
+ * @param spans 返回的可写内存段
+ * @return 实际预留的长度，为0时不持有锁，无需提交
  */
-bool circular_buffer_init(circular_buffer *cb, size_t size)
+size_t circular_buffer_write_reserve_policy(circular_buffer *cb, size_t length, circular_buffer_spans *spans)
 {
-    // 检查size是否为2的幂次
-    if (size == 0 || !is_power_of_two(size))
+    if (length == 0 || (cb->flags & CIRCULAR_BUFFER_FLAG_MULTI_PRODUCER))
     {
-        return false;                      // 缓冲区大小必须为2的幂次
+        return 0; // 与circular_buffer_write_reserve相同的限制
     }
-    cb->size = size;                       // 设置缓冲区大小
-    cb->start = 0;                         // 初始化起始位置为0
-    cb->end = 0;                           // 初始化结束位置为0
-    cb->buffer = (char *)malloc(cb->size); // 分配缓冲区空间
-    if (cb->buffer == NULL)
+#if !ENABLE_LOCK
+    if (cb->policy == CIRCULAR_BUFFER_POLICY_OVERWRITE)
     {
-        return false;                      // 分配失败返回false
+        return 0; // 无锁覆盖模式依赖写入端在拷贝前声明claim，预留期间无法保护读取端
     }
-    memset(cb->buffer, 0, cb->size);       // 清零缓冲区内存
-    // 初始化互斥锁，防止多线程竞争
-    if (!mutex_init(&cb->mutex))
-    {                     // 初始化互斥锁
-        free(cb->buffer); // 若互斥锁初始化失败，释放已分配的内存
-        return false;     // 互斥锁初始化失败返回false
+#endif
+
+    mutex_lock(PRODUCER_MUTEX(cb)); // 加锁，预留成功时在circular_buffer_write_commit中解锁
+    size_t end = atomic_load_explicit(&cb->end, memory_order_relaxed);
+#if ENABLE_LOCK
+    if (cb->policy == CIRCULAR_BUFFER_POLICY_OVERWRITE)
+    {
+        // 与write_overwrite相同：最多预留size个字节，空间不足时丢弃最早的数据
+        if (length > cb->size)
+        {
+            length = cb->size;
+        }
+        overwrite_make_room(cb, end, length);
     }
-    return true;          // 成功初始化缓冲区
+    else
+#endif
+    {
+        size_t start = producer_load_start(cb, end, length);
+        size_t available_space = cb->size - (end - start);
+        if (available_space < length)
+        {
+            if (cb->policy == CIRCULAR_BUFFER_POLICY_REJECT || available_space == 0)
+            {
+                mutex_unlock(PRODUCER_MUTEX(cb)); // 拒绝新数据，或截断后没有可写空间
+                return 0;
+            }
+            length = available_space; // 截断新数据，只预留剩余空间
+        }
+    }
+
+    fill_spans(cb, end & (cb->size - 1), length, spans);
+    cb->reserved = length;
+    return length;
 }
 
 /**
- * @brief 释放环形缓冲区资源
+ * @brief 在生产者锁内预留end之后的全部剩余空间（零拷贝写入）
  *
  * @param cb 环形缓冲区结构体指针
+ * @param spans 返回的可写内存段
+ * @return 预留的长度，缓冲区已满时返回0
  */
-void circular_buffer_free(circular_buffer *cb)
+size_t circular_buffer_write_reserve_available(circular_buffer *cb, circular_buffer_spans *spans)
 {
-    if (cb->buffer)
+    if (cb->flags & CIRCULAR_BUFFER_FLAG_MULTI_PRODUCER)
     {
-        free(cb->buffer);      // 释放缓冲区内存
-        cb->buffer = NULL;     // 将指针置空，避免野指针
+        return 0; // 与circular_buffer_write_reserve相同的限制
     }
-    mutex_destroy(&cb->mutex); // 销毁互斥锁
-    cb->size = 0;              // 重置缓冲区大小
-    cb->start = 0;             // 重置起始位置
-    cb->end = 0;               // 重置结束位置
+
+    mutex_lock(PRODUCER_MUTEX(cb)); // 加锁，预留成功时在circular_buffer_write_commit中解锁
+    // 持锁后才计算剩余空间，其他写入端无法在计算和预留之间写入；
+    // 需要全部剩余空间，按size请求使缓存视图总是刷新为最新的start
+    size_t end = atomic_load_explicit(&cb->end, memory_order_relaxed);
+    size_t start = producer_load_start(cb, end, cb->size);
+    size_t available_space = cb->size - (end - start);
+    if (available_space == 0)
+    {
+        mutex_unlock(PRODUCER_MUTEX(cb)); // 缓冲区已满
+        return 0;
+    }
+
+    fill_spans(cb, end & (cb->size - 1), available_space, spans);
+    cb->reserved = available_space;
+    return available_space;
 }
 
 /**
- * @brief 向环形缓冲区写入数据
+ * @brief 提交通过circular_buffer_write_reserve预留的空间
  *
  * @param cb 环形缓冲区结构体指针
- * @param data 写入数据的指针
- * @param length 写入数据的长度
- * @return 成功返回true，失败返回false
+ * @param length 实际写入的长度，不能超过预留长度
+ * @return 成功返回true，超过预留长度返回false（此时不发布任何数据）
  */
-bool circular_buffer_write(circular_buffer *cb, const char *data, size_t length)
+bool circular_buffer_write_commit(circular_buffer *cb, size_t length)
 {
-    if (length == 0)
+    bool committed = (length <= cb->reserved);
+    if (committed)
     {
-        return false; // 写入数据长度不能为0
+        // 与circular_buffer_write相同，使用release发布end
+        size_t end = atomic_load_explicit(&cb->end, memory_order_relaxed);
+        atomic_store_explicit(&cb->end, end + length, memory_order_release);
     }
+    cb->reserved = 0;
+    producer_unlock_notify(cb); // 解锁，与circular_buffer_write_reserve中的加锁对应
+    return committed;
+}
 
-    DEBUG_PRINT("尝试获取写锁\n");
-    mutex_lock(&cb->mutex); // 加锁，防止多线程同时访问缓冲区
-    DEBUG_PRINT("已获取写锁\n");
+/**
+ * @brief 获取环形缓冲区内全部可读数据的只读视图（零拷贝读取）
+ *
+ * @param cb 环形缓冲区结构体指针
+ * @param spans 返回的可读内存段
+ * @return 可读数据总长度，为0时表示缓冲区为空且无需调用circular_buffer_consume
+ */
+size_t circular_buffer_peek_spans(circular_buffer *cb, circular_buffer_spans *spans)
+{
+    mutex_lock(CONSUMER_MUTEX(cb)); // 加锁，返回值大于0时在circular_buffer_consume中解锁
 
-    // 计算缓冲区内的有效数据长度
-    // 使用位操作确保索引在0到size-1范围内，处理缓冲区环绕情况
-    // 例如，假设缓冲区大小为8，则掩码为0111
-    // 比如end=10, start=2，则current_length = (10-2) & 7 = 8 & 7 = 0
-    // 也就是说，end的值大于size时，会自动回绕到缓冲区起始位置
-    // 图示:
-    // start
-    //  |
-    // [ ][ ][X][X][X][ ][ ][ ]
-    //          |
-    //         end
-    // current_length = (end - start) & (size - 1)
-    //                = (10 - 2) & (8 - 1)
-    //                = 8 & 7
-    //                = 0
-    size_t current_length = (cb->end - cb->start) & (cb->size - 1);
-    // 计算缓冲区剩余空间大小
-    // 缓冲区总大小减去当前有效数据长度再减1，以区分缓冲区满和空的状态
-    // 若缓冲区大小为8，current_length = 5，则available_space = 8 - 5 - 1 = 2
-    // 图示:
-    // 缓冲区大小为8
-    // start
-    //  |
-    // [ ][ ][X][X][X][X][ ][ ]
-    //              |
-    //             end
-    // available_space = size - current_length - 1
-    //                 = 8 - 5 - 1
-    //                 = 2
-    size_t available_space = cb->size - current_length - 1;
+    // 需要全部可读数据，直接以acquire语义读取共享的end，并同步消费者缓存
+    size_t start = atomic_load_explicit(&cb->start, memory_order_relaxed);
+    size_t end = atomic_load_explicit(&cb->end, memory_order_acquire);
+#if CIRCULAR_BUFFER_SEPARATE_INDEX
+    cb->cached_end = end;
+#endif
+#if !ENABLE_LOCK
+    if (cb->policy == CIRCULAR_BUFFER_POLICY_OVERWRITE && end - start > cb->size)
+    {
+        start = end - cb->size; // 已被套圈，跳到最早的有效数据
+        atomic_store_explicit(&cb->start, start, memory_order_release);
+    }
+#endif
+    size_t current_length = end - start;
 
-    // 如果剩余空间不足以写入新数据
-    if (available_space < length)
+    fill_spans(cb, start & (cb->size - 1), current_length, spans);
+    if (current_length == 0)
     {
-#if CIRCULAR_BUFFER_OVERWRITE
-        // 覆盖旧数据
-        // 如果新数据长度大于可用空间，计算需要覆盖的字节数
-        // 若length = 4，则excess = 4 - 2 = 2
-        size_t excess = length - available_space;
-        // 更新起始位置，将起始位置向前移动excess个位置，使用环绕效果
-        // 假设start = 2, excess = 2, size = 8
-        // new_start = (2 + 2) & 7 = 4 & 7 = 4
-        cb->start = (cb->start + excess) & (cb->size - 1);
-#else
-        DEBUG_PRINT("缓冲区空间不足，无法写入\n");
-        mutex_unlock(&cb->mutex); // 解锁
-        return false;             // 缓冲区空间不足，丢弃新数据
+        mutex_unlock(CONSUMER_MUTEX(cb)); // 缓冲区为空，直接解锁
+        return 0;
+    }
+    cb->peeked = current_length;
+    return current_length;
+}
+
+/**
+ * @brief 消费通过circular_buffer_peek_spans获取的数据
+ *
+ * @param cb 环形缓冲区结构体指针
+ * @param length 消费的长度，不能超过circular_buffer_peek_spans返回的长度
+ * @return 成功返回true，超过可读长度返回false（此时不消费任何数据）
+ */
+bool circular_buffer_consume(circular_buffer *cb, size_t length)
+{
+    bool consumed = (length <= cb->peeked);
+#if !ENABLE_LOCK
+    if (consumed && cb->policy == CIRCULAR_BUFFER_POLICY_OVERWRITE)
+    {
+        // 写入端可能在调用者访问期间覆盖了这段数据，访问结束后再校验
+        size_t start = atomic_load_explicit(&cb->start, memory_order_relaxed);
+        size_t claim;
+        if (!overwrite_validate(cb, start, &claim))
+        {
+            // 调用者读到的数据可能不完整，应当丢弃；跳到最早的有效数据
+            atomic_store_explicit(&cb->start, claim - cb->size, memory_order_release);
+            consumed = false;
+        }
+    }
 #endif
+    if (consumed)
+    {
+        // 与circular_buffer_read相同，使用release释放start
+        size_t start = atomic_load_explicit(&cb->start, memory_order_relaxed);
+        atomic_store_explicit(&cb->start, start + length, memory_order_release);
     }
+    cb->peeked = 0;
+    consumer_unlock_notify(cb); // 解锁，与circular_buffer_peek_spans中的加锁对应
+    return consumed;
+}
+
+// 消息记录格式：[长度头(4字节)][负载][对齐填充]，整条记录按MSG_ALIGN对齐，
+// 缓冲区大小是2的幂次且不小于MSG_ALIGN时，长度头永远不会跨越环绕点
+#define MSG_HEADER_SIZE sizeof(uint32_t)
+#define MSG_ALIGN       sizeof(uint32_t)
+// 长度头取该值时表示从此处到环绕点都是填充，下一条记录从缓冲区起始位置开始
+#define MSG_SKIP        UINT32_MAX
+
+/**
+ * @brief 检查写入记录时是否需要在环绕点前填充，使每条记录在内存中连续
+ *
+ * 镜像映射的缓冲区中任何记录本来就是连续的，无需填充。
+ *
+ * @param cb 环形缓冲区结构体指针
+ * @return 需要填充返回true
+ */
+static bool msg_needs_padding(const circular_buffer *cb)
+{
+    return (cb->flags & CIRCULAR_BUFFER_FLAG_CONTIGUOUS_MSG) && !(cb->flags & CIRCULAR_BUFFER_FLAG_MIRROR);
+}
+
+/**
+ * @brief 计算一条消息记录占用的空间
+ *
+ * @param length 负载长度
+ * @return 长度头 + 负载，向上对齐到MSG_ALIGN
+ */
+static size_t msg_record_size(size_t length)
+{
+    return (MSG_HEADER_SIZE + length + MSG_ALIGN - 1) & ~(size_t)(MSG_ALIGN - 1);
+}
+
+/**
+ * @brief 检查负载长度是否超过单条消息的上限
+ *
+ * 保持记录连续时，记录若不超过size / 2，环绕点前的填充加上记录一定不超过size：
+ * 需要填充说明记录越过了环绕点，即环绕点之前剩余的空间小于记录，
+ * 而剩余空间不小于size / 2时不会出现这种情况，因此填充 + 记录 < size / 2 + size / 2。
+ * 否则空缓冲区也可能永远放不下这条记录。
+ *
+ * @param cb 环形缓冲区结构体指针
+ * @param length 负载长度
+ * @return 超过上限返回true
+ */
+static bool msg_too_long(const circular_buffer *cb, size_t length)
+{
+    size_t limit = msg_needs_padding(cb) ? cb->size / 2 : cb->size;
+    return length >= MSG_SKIP || length > limit || msg_record_size(length) > limit;
+}
 
-    // 循环写入数据到缓冲区
-    for (size_t i = 0; i < length; ++i)
+/**
+ * @brief 计算写入一条记录前需要在环绕点前填充的长度
+ *
+ * @param cb 环形缓冲区结构体指针
+ * @param end 记录的写入位置
+ * @param record 记录占用的空间
+ * @return 填充长度，不需要填充时为0
+ */
+static size_t msg_padding(const circular_buffer *cb, size_t end, size_t record)
+{
+    if (!msg_needs_padding(cb))
     {
-        cb->buffer[cb->end] = data[i]; // 将数据写入缓冲区
-        // 更新结束位置，使用环绕效果
-        // 假设end = 3, size = 8, end = (3+1) & 7 = 4 & 7 = 4
-        // 图示:
-        // 写入数据前
-        // start
-        //  |
-        // [ ][ ][ ][ ][ ][ ][ ][ ]
-        //    |
-        //   end
-        // 写入数据后
-        // start
-        //  |
-        // [ ][ ][X][ ][ ][ ][ ][ ]
-        //      |
-        //     end
-        cb->end = (cb->end + 1) & (cb->size - 1);
+        return 0;
     }
+    // 若size=16, end=12, record=8，环绕点前只剩4个字节，填充4个字节后从0开始写入
+    // 图示:
+    //                                      end
+    //                                       |
+    // [R][R][R][R][R][R][R][R][ ][ ][ ][ ][S][S][S][S]
+    //  |
+    // 记录写在这里，S为填充
+    size_t to_wrap = cb->size - (end & (cb->size - 1));
+    return (record > to_wrap) ? to_wrap : 0;
+}
 
-    DEBUG_PRINT("写入完成，释放写锁\n");
-    mutex_unlock(&cb->mutex); // 解锁
-    return true;              // 数据写入成功
+/**
+ * @brief 在指定位置写入一条消息记录（长度头和负载），不发布
+ *
+ * @param cb 环形缓冲区结构体指针
+ * @param position 记录的写入位置
+ * @param data 负载指针
+ * @param length 负载长度
+ */
+static void msg_write_record(circular_buffer *cb, size_t position, const void *data, size_t length)
+{
+    uint32_t header = (uint32_t)length;
+    copy_to_buffer(cb, position & (cb->size - 1), (const char *)&header, MSG_HEADER_SIZE);
+    copy_to_buffer(cb, (position + MSG_HEADER_SIZE) & (cb->size - 1), (const char *)data, length);
 }
 
 /**
- * @brief 从环形缓冲区读取数据
+ * @brief 读取第一条消息的位置和负载长度，跳过环绕点前的填充，调用者需持有消费者锁
+ *
+ * 填充和紧随其后的记录由写入端在同一次发布中提交，看到填充标记时记录一定已经完整写入。
  *
  * @param cb 环形缓冲区结构体指针
- * @param data 读取数据的指针
- * @param length 读取数据的长度
- * @return 成功返回true，失败返回false
+ * @param position 返回记录的起始位置（填充之后）
+ * @param length 返回负载长度
+ * @return 有消息返回true，缓冲区为空返回false
  */
-bool circular_buffer_read(circular_buffer *cb, char *data, size_t length)
+static bool msg_load_front(circular_buffer *cb, size_t *position, size_t *length)
 {
-    if (length == 0)
+    size_t start = atomic_load_explicit(&cb->start, memory_order_relaxed);
+    size_t end = consumer_load_end(cb, start, MSG_HEADER_SIZE);
+    if (end - start < MSG_HEADER_SIZE)
     {
-        return false; // 读取数据长度不能为0
+        return false;
+    }
+    uint32_t header;
+    copy_from_buffer(cb, start & (cb->size - 1), (char *)&header, MSG_HEADER_SIZE);
+    if (header == MSG_SKIP)
+    {
+        start += cb->size - (start & (cb->size - 1)); // 跳到环绕点
+        copy_from_buffer(cb, 0, (char *)&header, MSG_HEADER_SIZE);
     }
+    *position = start;
+    *length = header;
+    return true;
+}
 
-    DEBUG_PRINT("尝试获取读锁\n");
-    mutex_lock(&cb->mutex); // 加锁，防止多线程同时访问缓冲区
-    DEBUG_PRINT("已获取读锁\n");
+/**
+ * @brief 写入一条消息
+ *
+ * @param cb 环形缓冲区结构体指针
+ * @param data 负载指针
+ * @param length 负载长度，可以为0
+ * @return 成功返回true，剩余空间不足或消息过长返回false
+ */
+bool circular_buffer_push_msg(circular_buffer *cb, const void *data, size_t length)
+{
+    if (msg_too_long(cb, length))
+    {
+        return false;
+    }
+    size_t record = msg_record_size(length);
 
-    // 计算缓冲区内的有效数据长度
-    // 使用位操作确保索引在0到size-1范围内，处理缓冲区环绕情况
-    // 若end=6, start=2, size=8, current_length = (6-2) & 7 = 4 & 7 = 4
-    // 图示:
-    // start
-    //  |
-    // [ ][ ][X][X][X][X][ ][ ]
-    //              |
-    //             end
-    // current_length = (end - start) & (size - 1)
-    //                = (6 - 2) & (8 - 1)
-    //                = 4 & 7
-    //                = 4
-    size_t current_length = (cb->end - cb->start) & (cb->size - 1);
-    // 如果有效数据长度小于请求的读取长度，则无法读取
-    if (current_length < length)
+    if (cb->flags & CIRCULAR_BUFFER_FLAG_MULTI_PRODUCER)
     {
-        DEBUG_PRINT("缓冲区数据不足，无法读取\n");
-        mutex_unlock(&cb->mutex); // 解锁
-        return false;             // 缓冲区数据不足
+        // 多生产者模式不保持记录连续（初始化时已拒绝），认领整条记录后并行写入，按序发布
+        size_t position;
+        if (multi_producer_claim(cb, record, false, &position) == 0)
+        {
+            return false;
+        }
+        msg_write_record(cb, position, data, length);
+        multi_producer_release(cb, position, record);
+        return true;
     }
 
-    // 循环从缓冲区读取数据
-    for (size_t i = 0; i < length; ++i)
-    {
-        data[i] = cb->buffer[cb->start]; // 从缓冲区读取数据
-        // 更新起始位置，使用环绕效果
-        // 假设start = 2, size = 8, start = (2+1) & 7 = 3 & 7 = 3
-        // 图示:
-        // 读取数据前
-        // start
-        //  |
-        // [ ][ ][X][ ][ ][ ][ ][ ]
-        //      |
-        //     end
-        // 读取数据后
-        //      start
-        //       |
-        // [ ][ ][ ][ ][ ][ ][ ][ ]
-        //      |
-        //     end
-        cb->start = (cb->start + 1) & (cb->size - 1);
+    mutex_lock(PRODUCER_MUTEX(cb)); // 加锁，防止多个生产者同时访问缓冲区
+    size_t end = atomic_load_explicit(&cb->end, memory_order_relaxed);
+    size_t padding = msg_padding(cb, end, record);
+    size_t start = producer_load_start(cb, end, padding + record);
+    if (cb->size - (end - start) < padding + record)
+    {
+        mutex_unlock(PRODUCER_MUTEX(cb)); // 空间不足，不写入任何数据
+        return false;
+    }
+    if (padding > 0)
+    {
+        uint32_t skip = MSG_SKIP; // 只需写入填充标记，其余填充字节不必写入
+        copy_to_buffer(cb, end & (cb->size - 1), (const char *)&skip, MSG_HEADER_SIZE);
     }
+    msg_write_record(cb, end + padding, data, length);
+    // 填充和记录在同一次发布中提交，读取端不会看到只写了一半的记录
+    atomic_store_explicit(&cb->end, end + padding + record, memory_order_release);
+    producer_unlock_notify(cb); // 解锁，有读取端在等待时唤醒
+    return true;
+}
 
-    DEBUG_PRINT("读取完成，释放读锁\n");
-    mutex_unlock(&cb->mutex); // 解锁
-    return true;              // 数据读取成功
+/**
+ * @brief 读取一条完整的消息
+ *
+ * @param cb 环形缓冲区结构体指针
+ * @param data 负载的目标缓冲区
+ * @param capacity 目标缓冲区的大小
+ * @param length 返回负载长度；缓冲区为空时返回0
+ * @return 成功返回true，缓冲区为空或capacity不足返回false
+ */
+bool circular_buffer_pop_msg(circular_buffer *cb, void *data, size_t capacity, size_t *length)
+{
+    mutex_lock(CONSUMER_MUTEX(cb)); // 加锁，防止多个消费者同时访问缓冲区
+    size_t position;
+    if (!msg_load_front(cb, &position, length))
+    {
+        *length = 0;
+        mutex_unlock(CONSUMER_MUTEX(cb)); // 缓冲区为空，直接解锁
+        return false;
+    }
+    if (*length > capacity)
+    {
+        mutex_unlock(CONSUMER_MUTEX(cb)); // 目标缓冲区不足，消息保留在缓冲区中
+        return false;
+    }
+    copy_from_buffer(cb, (position + MSG_HEADER_SIZE) & (cb->size - 1), (char *)data, *length);
+    atomic_store_explicit(&cb->start, position + msg_record_size(*length), memory_order_release);
+    consumer_unlock_notify(cb); // 解锁，有写入端在等待时唤醒
+    return true;
+}
+
+/**
+ * @brief 获取第一条消息负载的只读视图（零拷贝读取）
+ *
+ * @param cb 环形缓冲区结构体指针
+ * @param spans 返回负载所在的内存段
+ * @return 有消息返回true（锁保持持有），缓冲区为空返回false
+ */
+bool circular_buffer_peek_msg(circular_buffer *cb, circular_buffer_spans *spans)
+{
+    mutex_lock(CONSUMER_MUTEX(cb)); // 加锁，返回true时在circular_buffer_consume_msg中解锁
+    size_t position;
+    size_t length;
+    if (!msg_load_front(cb, &position, &length))
+    {
+        spans->count = 0;
+        mutex_unlock(CONSUMER_MUTEX(cb)); // 缓冲区为空，直接解锁
+        return false;
+    }
+    fill_spans(cb, (position + MSG_HEADER_SIZE) & (cb->size - 1), length, spans);
+    // 记录消费时start需要前进的距离，包括记录之前跳过的填充
+    size_t start = atomic_load_explicit(&cb->start, memory_order_relaxed);
+    cb->peeked = position - start + msg_record_size(length);
+    return true;
+}
+
+/**
+ * @brief 消费通过circular_buffer_peek_msg获取的消息
+ *
+ * @param cb 环形缓冲区结构体指针
+ */
+void circular_buffer_consume_msg(circular_buffer *cb)
+{
+    size_t start = atomic_load_explicit(&cb->start, memory_order_relaxed);
+    atomic_store_explicit(&cb->start, start + cb->peeked, memory_order_release);
+    cb->peeked = 0;
+    consumer_unlock_notify(cb); // 解锁，与circular_buffer_peek_msg中的加锁对应
+}
+
+/**
+ * @brief 读取start和end的一致快照，计算有效数据长度
+ *
+ * 状态查询不加锁，只通过两次acquire原子读取获得索引。两次读取之间读写端可能继续推进，
+ * 因此必须先读start再读end：
+ * start只增不减，end始终不小于start，后读到的end一定不小于先读到的start，差值不会下溢；
+ * 反过来先读end时，读取端可能在两次读取之间越过旧的end，差值会下溢为一个巨大的值。
+ * 先读start时，读取端在两次读取之间释放空间、写入端随即填满，差值可能超过size，
+ * 无锁覆盖模式下被套圈的读取端尚未重新同步时也是如此，因此结果截断到size。
+ *
+ * 图示（size = 8）:
+ * 读取start = 2  ->  读取端读走2字节、写入端写入4字节  ->  读取end = 12
+ * end - start = 10 > size，返回8
+ *
+ * @param cb 环形缓冲区结构体指针
+ * @return 有效数据长度（0到size）
+ */
+static size_t snapshot_length(circular_buffer *cb)
+{
+    size_t start = atomic_load_explicit(&cb->start, memory_order_acquire);
+    size_t end = atomic_load_explicit(&cb->end, memory_order_acquire);
+    size_t length = end - start;
+    return (length > cb->size) ? cb->size : length;
 }
 
 /**
  * @brief 获取环形缓冲区中的有效数据长度
  *
+ * 不获取互斥锁，返回值是调用期间某一时刻附近的快照，见snapshot_length。
+ *
  * @param cb 环形缓冲区结构体指针
  * @return 有效数据长度
  */
 size_t circular_buffer_length(circular_buffer *cb)
 {
-    size_t length;
-    mutex_lock(&cb->mutex); // 加锁，防止多线程同时访问缓冲区
-    // 计算有效数据长度，使用位操作实现环绕效果
-    // 若end=6, start=2, size=8, length = (6-2) & 7 = 4 & 7 = 4
+    // 计算有效数据长度，start和end自由增长，两者之差即为有效数据长度
+    // 若end=6, start=2, size=8, length = 6 - 2 = 4
     // 图示:
     // start
     //  |
     // [ ][ ][X][X][X][X][ ][ ]
     //              |
     //             end
-    // length = (end - start) & (size - 1)
-    //        = (6 - 2) & (8 - 1)
-    //        = 4 & 7
+    // length = end - start
+    //        = 6 - 2
     //        = 4
-    length = (cb->end - cb->start) & (cb->size - 1);
-    mutex_unlock(&cb->mutex); // 解锁
-    return length;
+    return snapshot_length(cb);
 }
 
 /**
  * @brief 检查环形缓冲区是否为空
  *
+ * 不获取互斥锁，返回值是调用期间某一时刻附近的快照，见snapshot_length。
+ *
  * @param cb 环形缓冲区结构体指针
  * @return 为空返回true，不为空返回false
  */
 bool circular_buffer_is_empty(circular_buffer *cb)
 {
-    bool is_empty;
-    mutex_lock(&cb->mutex); // 加锁，防止多线程同时访问缓冲区
     // 起始位置等于结束位置表示缓冲区为空
     // 若start=3, end=3, 则缓冲区为空
     // 图示:
@@ -312,36 +2077,28 @@ bool circular_buffer_is_empty(circular_buffer *cb)
     // [ ][ ][ ][ ][ ][ ][ ][ ]
     //  |
     // start/end
-    is_empty = (cb->start == cb->end);
-    mutex_unlock(&cb->mutex); // 解锁
-    return is_empty;
+    return snapshot_length(cb) == 0;
 }
 
 /**
  * @brief 检查环形缓冲区是否已满
  *
+ * 不获取互斥锁，返回值是调用期间某一时刻附近的快照，见snapshot_length。
+ *
  * @param cb 环形缓冲区结构体指针
  * @return 已满返回true，未满返回false
  */
 bool circular_buffer_is_full(circular_buffer *cb)
 {
-    bool is_full;
-    mutex_lock(&cb->mutex); // 加锁，防止多线程同时访问缓冲区
-    // 检查缓冲区是否已满，使用位操作实现环绕效果
-    // 当结束位置的下一个位置等于起始位置时，缓冲区已满
-    // 若end=7, start=0, size=8, is_full = ((7+1) & 7) == 0 = 0 == 0 = true
+    // 检查缓冲区是否已满
+    // 当有效数据长度等于缓冲区大小时，缓冲区已满
+    // 若end=8, start=0, size=8, is_full = (8 - 0) == 8 = true
     // 图示:
-    // start
+    // start/end
     //  |
-    // [ ][X][X][X][X][X][X][X]
-    //                     |
-    //                    end
-    // is_full = ((end + 1) & (size - 1)) == start
-    //         = ((7 + 1) & (8 - 1)) == 0
-    //         = (8 & 7) == 0
-    //         = 0 == 0
+    // [X][X][X][X][X][X][X][X]
+    // is_full = (end - start) == size
+    //         = (8 - 0) == 8
     //         = true
-    is_full = ((cb->end + 1) & (cb->size - 1)) == cb->start;
-    mutex_unlock(&cb->mutex); // 解锁
-    return is_full;
+    return snapshot_length(cb) == cb->size;
 }
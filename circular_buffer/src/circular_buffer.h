@@ -2,25 +2,227 @@
 #ifndef CIRCULAR_BUFFER_H
 #define CIRCULAR_BUFFER_H
 
+#include <stdatomic.h>
 #include <stdbool.h>
 #include <stddef.h>
 #include "port.h"
 
-// 策略宏定义（1 表示覆盖旧数据，0 表示丢弃新数据）
-#define CIRCULAR_BUFFER_OVERWRITE 0
+// 等待接口的无限等待超时时间
+#define CIRCULAR_BUFFER_WAIT_FOREVER PORT_WAIT_FOREVER
+
+// 索引分离布局下按缓存行对齐，紧凑布局下为空
+#if CIRCULAR_BUFFER_SEPARATE_INDEX
+#define CIRCULAR_BUFFER_CACHE_ALIGNED _Alignas(CIRCULAR_BUFFER_CACHE_LINE_SIZE)
+#else
+#define CIRCULAR_BUFFER_CACHE_ALIGNED
+#endif
+
+// 读写分离锁只在启用锁时生效
+#define CIRCULAR_BUFFER_USE_SPLIT_LOCK (ENABLE_LOCK && CIRCULAR_BUFFER_SPLIT_LOCK)
+
+/**
+ * @brief 初始化选项标志
+ */
+enum
+{
+    /**
+     * 镜像映射分配：将同一块内存在虚拟地址空间中连续映射两次，
+     * 任意位置开始、长度不超过size的区域都是一段连续内存，读写无需处理环绕。
+     * size必须为页大小的整数倍，仅Linux平台支持。
+     */
+    CIRCULAR_BUFFER_FLAG_MIRROR = 1u << 0,
+    /**
+     * 多生产者单消费者：写入端不加锁，通过CAS推进预留游标claim认领一段空间，
+     * 各生产者并行拷贝数据，再按认领顺序依次发布end，消费者不会看到写了一半的区域。
+     * 消费端接口与单生产者模式相同，仍然只允许一个消费者。
+     * 此模式下不支持circular_buffer_write_reserve，也不能与覆盖旧数据策略同时使用。
+     */
+    CIRCULAR_BUFFER_FLAG_MULTI_PRODUCER = 1u << 1,
+    /**
+     * 缓冲区内存由调用者提供，circular_buffer_free不释放。
+     * 由circular_buffer_init_static和CIRCULAR_BUFFER_INITIALIZER自动设置，
+     * 传给circular_buffer_init_ex时初始化失败。
+     */
+    CIRCULAR_BUFFER_FLAG_STATIC_STORAGE = 1u << 2,
+    /**
+     * 以下为大容量缓冲区的内存放置提示，尽力而为，不可用时逐级回退，不会导致初始化失败：
+     * 显式大页回退到透明大页，透明大页回退到普通页，NUMA策略设置失败时保持默认策略，
+     * 全部提示都未生效时改用malloc。初始化后flags中只保留实际生效的提示。
+     * 与镜像映射同时指定时忽略这些提示。仅Linux平台支持。
+     */
+    /** 使用显式大页（需要系统通过vm.nr_hugepages预留），size需为CIRCULAR_BUFFER_HUGE_PAGE_SIZE的整数倍 */
+    CIRCULAR_BUFFER_FLAG_HUGE_PAGES = 1u << 3,
+    /** 使用透明大页：映射按大页对齐并通过madvise请求内核以大页填充 */
+    CIRCULAR_BUFFER_FLAG_TRANSPARENT_HUGE_PAGES = 1u << 4,
+    /** 将缓冲区绑定到options.numa_node指定的NUMA节点 */
+    CIRCULAR_BUFFER_FLAG_NUMA_BIND = 1u << 5,
+    /** 将缓冲区在进程允许的全部NUMA节点间交错分布 */
+    CIRCULAR_BUFFER_FLAG_NUMA_INTERLEAVE = 1u << 6,
+    /**
+     * 消息模式下保持每条记录在内存中连续：记录会越过环绕点时，在环绕点前写入填充标记，
+     * 记录从缓冲区起始位置开始写入，circular_buffer_peek_msg总是只返回一段内存。
+     * 单条消息的上限随之降为size / 2减去长度头，不能与多生产者模式同时使用。
+     */
+    CIRCULAR_BUFFER_FLAG_CONTIGUOUS_MSG = 1u << 7,
+    /**
+     * 环形缓冲区位于多个进程共享的内存段中（circular_buffer_shared.h）：
+     * 数据区位于结构体之后data_offset字节处，按结构体自身地址定位，buffer不使用；
+     * 启用锁时互斥锁和条件变量为进程间共享的健壮锁，关闭锁时futex跨进程唤醒。
+     * 由circular_buffer_create_shared设置，传给circular_buffer_init_ex时初始化失败。
+     */
+    CIRCULAR_BUFFER_FLAG_SHARED = 1u << 8,
+};
+
+/**
+ * @brief 剩余空间不足时circular_buffer_write的写入策略
+ *
+ * 策略随实例保存，同一程序中可以同时存在不同策略的环形缓冲区。
+ * 写入时按策略直接调用对应的写入函数，热路径上没有策略判断。
+ */
+typedef enum
+{
+    CIRCULAR_BUFFER_POLICY_REJECT = 0, /**< 拒绝新数据：空间不足时不写入任何数据并返回false（默认） */
+    /**
+     * 覆盖旧数据：丢弃最早的数据腾出空间，写入总是成功。
+     * 启用锁时由写入端移动start；关闭锁时写入端从不等待也不访问start，
+     * 读取端自行检测是否被套圈并跳到最早的有效数据，不会读到被覆盖了一半的数据。
+     */
+    CIRCULAR_BUFFER_POLICY_OVERWRITE,
+    CIRCULAR_BUFFER_POLICY_TRUNCATE,   /**< 截断新数据：只写入剩余空间能容纳的前缀，写入至少一个字节即返回true */
+    CIRCULAR_BUFFER_POLICY_COUNT,
+} circular_buffer_policy;
+
+/**
+ * @brief 环形缓冲区初始化选项
+ */
+typedef struct
+{
+    unsigned int flags;            /**< CIRCULAR_BUFFER_FLAG_*的组合 */
+    circular_buffer_policy policy; /**< 剩余空间不足时的写入策略 */
+    int numa_node;                 /**< 指定CIRCULAR_BUFFER_FLAG_NUMA_BIND时绑定的NUMA节点编号 */
+} circular_buffer_options;
+
+/**
+ * @brief 环形缓冲区内的一段连续内存
+ */
+typedef struct
+{
+    char *data;    /**< 连续内存起始地址，指向环形缓冲区内部 */
+    size_t length; /**< 连续内存长度 */
+} circular_buffer_span;
+
+/**
+ * @brief 环形缓冲区内的连续内存视图
+ *
+ * 一段逻辑上连续的区域在环绕点处最多被拆分为两段，
+ * span[0]为环绕点之前的部分，span[1]为环绕点之后的部分（可能为空）。
+ */
+typedef struct
+{
+    circular_buffer_span span[2]; /**< 连续内存段 */
+    size_t count;                 /**< 有效的段数（0、1或2） */
+} circular_buffer_spans;
 
 /**
  * @brief 环形缓冲区结构体
+ *
+ * start和end是自由增长的计数器，访问缓冲区时才通过掩码size-1映射到实际位置，
+ * end - start即为有效数据长度（0到size），因此全部size个字节均可使用。
+ * start只由消费者修改，end只由生产者修改。两者均为原子变量：
+ * 修改方使用release发布自己的索引，另一方使用acquire读取，
+ * 在关闭锁（ENABLE_LOCK为0）的单生产者单消费者模式下即可保证数据交接正确。
+ *
+ * 启用CIRCULAR_BUFFER_SEPARATE_INDEX时，只读区、生产者区、消费者区各占独立的缓存行，
+ * 生产者写入时只修改生产者区，消费者读取时只修改消费者区。
+ *
+ * 启用CIRCULAR_BUFFER_SPLIT_LOCK时，生产者锁和消费者锁分别放在生产者区和消费者区，
+ * 写入端只持有生产者锁、读取端只持有消费者锁，对方的索引通过acquire原子读取。
  */
 typedef struct
 {
-    size_t size;   /**< 缓冲区大小（必须为2的幂次） */
-    size_t start;  /**< 起始位置（读取位置） */
-    size_t end;    /**< 结束位置（写入位置） */
-    char *buffer;  /**< 缓冲区数据指针 */
-    mutex_t mutex; /**< 平台无关的互斥锁 */
+    // 只读区：初始化后不再修改
+    size_t size;        /**< 缓冲区大小（必须为2的幂次） */
+    char *buffer;       /**< 缓冲区数据指针，共享内存模式下为NULL */
+    size_t data_offset; /**< 共享内存模式下数据区相对结构体起始地址的偏移，各进程映射地址不同时仍然有效 */
+    unsigned int flags; /**< 初始化时指定的CIRCULAR_BUFFER_FLAG_*组合 */
+    circular_buffer_policy policy; /**< 剩余空间不足时的写入策略 */
+
+    // 生产者区
+    CIRCULAR_BUFFER_CACHE_ALIGNED atomic_size_t end; /**< 结束位置（写入位置），由生产者发布 */
+    atomic_size_t claim; /**< 多生产者模式下的预留游标；无锁覆盖模式下为正在进行的写入的结束位置 */
+    atomic_uint publish_wait; /**< 多生产者模式下等待前序生产者发布的线程在futex上休眠前置1 */
+#if CIRCULAR_BUFFER_SEPARATE_INDEX
+    size_t cached_start; /**< 生产者本地缓存的start，只在空间不足时刷新 */
+#endif
+    size_t reserved; /**< circular_buffer_write_reserve预留、尚未提交的字节数 */
+#if CIRCULAR_BUFFER_USE_SPLIT_LOCK
+    mutex_t write_mutex; /**< 生产者锁，串行化写入端对end的更新，等待空间时配合writable使用 */
+#endif
+
+    // 消费者区
+    CIRCULAR_BUFFER_CACHE_ALIGNED atomic_size_t start; /**< 起始位置（读取位置），由消费者发布 */
+#if CIRCULAR_BUFFER_SEPARATE_INDEX
+    size_t cached_end; /**< 消费者本地缓存的end，只在数据不足时刷新 */
+#endif
+    size_t peeked; /**< circular_buffer_peek_spans返回、尚未消费的字节数 */
+#if CIRCULAR_BUFFER_USE_SPLIT_LOCK
+    mutex_t read_mutex; /**< 消费者锁，串行化读取端对start的更新，等待数据时配合readable使用 */
+#else
+    CIRCULAR_BUFFER_CACHE_ALIGNED mutex_t mutex; /**< 平台无关的互斥锁，读写共用 */
+#endif
+#if ENABLE_LOCK
+    cond_t readable;           /**< 有新数据时通知等待读取的线程 */
+    cond_t writable;           /**< 有新空间时通知等待写入的线程 */
+    atomic_uint read_waiters;  /**< 等待数据的读取端数量，持有消费者锁时修改，写入端可不加锁读取 */
+    atomic_uint write_waiters; /**< 等待空间的写入端数量，持有生产者锁时修改，读取端可不加锁读取 */
+#else
+    atomic_uint read_wait;  /**< 读取端在futex上休眠前置1，写入端发布数据后清零并唤醒 */
+    atomic_uint write_wait; /**< 写入端在futex上休眠前置1，读取端释放空间后清零并唤醒 */
+#endif
 } circular_buffer;
 
+// 编译期检查静态初始化的size是否为2的幂次，不满足时数组长度为负，编译报错
+#define CIRCULAR_BUFFER_STATIC_SIZE(size) \
+    ((size) + 0 * sizeof(char[((size) != 0 && ((size) & ((size) - 1)) == 0) ? 1 : -1]))
+
+// 静态初始化时需要初始化的锁字段，随锁配置变化
+#if CIRCULAR_BUFFER_USE_SPLIT_LOCK
+#define CIRCULAR_BUFFER_LOCK_INITIALIZER \
+    .write_mutex = MUTEX_INITIALIZER, .read_mutex = MUTEX_INITIALIZER, \
+    .readable = COND_INITIALIZER, .writable = COND_INITIALIZER,
+#elif ENABLE_LOCK
+#define CIRCULAR_BUFFER_LOCK_INITIALIZER \
+    .mutex = MUTEX_INITIALIZER, .readable = COND_INITIALIZER, .writable = COND_INITIALIZER,
+#else
+#define CIRCULAR_BUFFER_LOCK_INITIALIZER
+#endif
+
+#if !ENABLE_LOCK || defined(MUTEX_INITIALIZER)
+/**
+ * @def CIRCULAR_BUFFER_INITIALIZER
+ * @brief 编译期初始化使用调用者内存的环形缓冲区，无需运行时初始化
+ *
+ * 索引、等待计数等字段全部为0，锁通过平台的静态初始化宏初始化，写入策略为拒绝新数据。
+ * size必须为编译期常量且为2的幂次，否则编译失败。
+ * 平台的锁只能在运行时创建（如FreeRTOS）时不提供此宏，请使用circular_buffer_init_static。
+ *
+ * 用法:
+ * static char storage[1024];
+ * static circular_buffer ring = CIRCULAR_BUFFER_INITIALIZER(storage, sizeof(storage));
+ *
+ * @param storage 缓冲区内存，生命周期不短于环形缓冲区
+ * @param buffer_size 缓冲区大小（必须为2的幂次）
+ */
+#define CIRCULAR_BUFFER_INITIALIZER(storage, buffer_size) \
+    { \
+        .size = CIRCULAR_BUFFER_STATIC_SIZE(buffer_size), \
+        .buffer = (char *)(storage), \
+        .flags = CIRCULAR_BUFFER_FLAG_STATIC_STORAGE, \
+        .policy = CIRCULAR_BUFFER_POLICY_REJECT, \
+        CIRCULAR_BUFFER_LOCK_INITIALIZER \
+    }
+#endif
+
 /**
  * @brief 初始化环形缓冲区
  *
@@ -30,6 +232,45 @@ typedef struct
  */
 bool circular_buffer_init(circular_buffer *cb, size_t size);
 
+/**
+ * @brief 按指定选项初始化环形缓冲区
+ *
+ * @param cb 环形缓冲区结构体指针
+ * @param size 缓冲区大小（必须为2的幂次）
+ * @param options 初始化选项，为NULL时与circular_buffer_init相同（拒绝新数据策略）
+ * @return 成功返回true，失败（包括平台不支持所选分配方式、多生产者模式下选择覆盖旧数据策略）返回false
+ */
+bool circular_buffer_init_ex(circular_buffer *cb, size_t size, const circular_buffer_options *options);
+
+/**
+ * @brief 使用调用者提供的内存初始化环形缓冲区
+ *
+ * 不调用malloc，也不清零缓冲区内存，storage可以位于.bss、大页区域或共享内存段中，
+ * 没有被写入过的页面在初始化时不会被访问。storage由调用者管理，circular_buffer_free不释放。
+ * 写入策略为拒绝新数据。
+ *
+ * @param cb 环形缓冲区结构体指针
+ * @param storage 缓冲区内存，至少size字节，生命周期不短于环形缓冲区
+ * @param size 缓冲区大小（必须为2的幂次）
+ * @return 成功返回true，失败返回false
+ */
+bool circular_buffer_init_static(circular_buffer *cb, void *storage, size_t size);
+
+/**
+ * @brief 按指定选项使用调用者提供的内存初始化环形缓冲区
+ *
+ * 与circular_buffer_init_static相同，options可以指定写入策略和多生产者模式；
+ * 镜像映射需要自行分配内存，此时初始化失败，大页和NUMA提示被忽略。
+ *
+ * @param cb 环形缓冲区结构体指针
+ * @param storage 缓冲区内存，至少size字节，生命周期不短于环形缓冲区
+ * @param size 缓冲区大小（必须为2的幂次）
+ * @param options 初始化选项，为NULL时与circular_buffer_init_static相同
+ * @return 成功返回true，失败返回false
+ */
+bool circular_buffer_init_static_ex(circular_buffer *cb, void *storage, size_t size,
+                                    const circular_buffer_options *options);
+
 /**
  * @brief 释放环形缓冲区资源
  *
@@ -40,6 +281,9 @@ void circular_buffer_free(circular_buffer *cb);
 /**
  * @brief 向环形缓冲区写入数据
  *
+ * 剩余空间不足时的行为由初始化时选择的circular_buffer_policy决定。
+ * 截断策略下需要知道实际写入长度时使用circular_buffer_write_some。
+ *
  * @param cb 环形缓冲区结构体指针
  * @param data 写入数据的指针
  * @param length 写入数据的长度
@@ -57,9 +301,196 @@ bool circular_buffer_write(circular_buffer *cb, const char *data, size_t length)
  */
 bool circular_buffer_read(circular_buffer *cb, char *data, size_t length);
 
+/**
+ * @brief 向环形缓冲区写入尽可能多的数据
+ *
+ * 在一次加锁内写入min(length, 剩余空间)个字节，不受写入策略影响，不会覆盖旧数据。
+ *
+ * @param cb 环形缓冲区结构体指针
+ * @param data 写入数据的指针
+ * @param length 请求写入的最大长度
+ * @return 实际写入的字节数，缓冲区已满时返回0
+ */
+size_t circular_buffer_write_some(circular_buffer *cb, const char *data, size_t length);
+
+/**
+ * @brief 从环形缓冲区读取尽可能多的数据
+ *
+ * 在一次加锁内读取min(length, 有效数据长度)个字节。
+ *
+ * @param cb 环形缓冲区结构体指针
+ * @param data 读取数据的指针
+ * @param length 请求读取的最大长度
+ * @return 实际读取的字节数，缓冲区为空时返回0
+ */
+size_t circular_buffer_read_some(circular_buffer *cb, char *data, size_t length);
+
+/**
+ * @brief 向环形缓冲区写入数据，空间不足时等待，最多等待timeout_ms毫秒
+ *
+ * 启用锁时，写入端在条件变量上休眠，读取端释放空间后唤醒；
+ * 只有存在等待者时读取端才会发出通知，无人等待时不增加额外开销。
+ * 关闭锁时，写入端先自旋CIRCULAR_BUFFER_SPIN_COUNT次，再在futex等待字上休眠，
+ * 读取端只在等待标志置位时才发起唤醒系统调用。
+ * 覆盖旧数据策略下不会等待；截断策略与拒绝策略相同，等待到全部数据都能写入为止。
+ * 没有时间源的平台（PORT_HAS_CLOCK为0，如裸机）上有限的timeout_ms无法计时，自旋阶段结束后即返回超时。
+ *
+ * @param cb 环形缓冲区结构体指针
+ * @param data 写入数据的指针
+ * @param length 写入数据的长度，不能超过缓冲区大小
+ * @param timeout_ms 超时时间（毫秒），0表示不等待，CIRCULAR_BUFFER_WAIT_FOREVER表示无限等待
+ * @return 成功返回true，超时或参数无效返回false
+ */
+bool circular_buffer_write_timed(circular_buffer *cb, const char *data, size_t length, uint32_t timeout_ms);
+
+/**
+ * @brief 从环形缓冲区读取数据，数据不足时等待，最多等待timeout_ms毫秒
+ *
+ * 启用锁时，读取端在条件变量上休眠，写入端发布数据后唤醒；
+ * 只有存在等待者时写入端才会发出通知。关闭锁时，读取端先自旋再在futex等待字上休眠，
+ * 写入端只在等待标志置位时才发起唤醒系统调用。
+ * 没有时间源的平台（PORT_HAS_CLOCK为0，如裸机）上有限的timeout_ms无法计时，自旋阶段结束后即返回超时。
+ *
+ * @param cb 环形缓冲区结构体指针
+ * @param data 读取数据的指针
+ * @param length 读取数据的长度，不能超过缓冲区大小
+ * @param timeout_ms 超时时间（毫秒），0表示不等待，CIRCULAR_BUFFER_WAIT_FOREVER表示无限等待
+ * @return 成功返回true，超时或参数无效返回false
+ */
+bool circular_buffer_read_timed(circular_buffer *cb, char *data, size_t length, uint32_t timeout_ms);
+
+/**
+ * @brief 在环形缓冲区内预留一段可写空间（零拷贝写入）
+ *
+ * 成功时spans返回最多两段位于缓冲区内部的可写内存，总长度为length，
+ * 调用者直接向其中写入数据后，通过circular_buffer_write_commit发布。
+ * 启用锁时，成功预留后锁保持持有，直到调用circular_buffer_write_commit才释放，
+ * 因此两者必须成对调用，且中间不能再调用本缓冲区的其他接口。
+ *
+ * @param cb 环形缓冲区结构体指针
+ * @param length 需要预留的长度
+ * @param spans 返回的可写内存段
+ * @return 成功返回true，长度为0、剩余空间不足或多生产者模式下返回false
+ */
+bool circular_buffer_write_reserve(circular_buffer *cb, size_t length, circular_buffer_spans *spans);
+
+/**
+ * @brief 提交通过circular_buffer_write_reserve预留的空间
+ *
+ * 只发布前length个字节，其余预留空间被放弃，length为0表示取消本次预留。
+ *
+ * @param cb 环形缓冲区结构体指针
+ * @param length 实际写入的长度，不能超过预留长度
+ * @return 成功返回true，超过预留长度返回false（此时不发布任何数据）
+ */
+bool circular_buffer_write_commit(circular_buffer *cb, size_t length);
+
+/**
+ * @brief 按写入策略预留写入空间（零拷贝写入）
+ *
+ * 与circular_buffer_write_reserve相同，预留成功后锁保持持有，直到调用circular_buffer_write_commit，
+ * 区别是剩余空间不足时按缓冲区的写入策略处理：
+ * 拒绝新数据时不预留；截断新数据时预留剩余的全部空间；
+ * 覆盖旧数据时最多预留size个字节，并丢弃最早的数据腾出空间（无锁模式下不支持，总是返回0）。
+ *
+ * @param cb 环形缓冲区结构体指针
+ * @param length 请求预留的长度
+ * @param spans 返回的可写内存段
+ * @return 实际预留的长度，为0时表示没有预留且无需调用circular_buffer_write_commit
+ */
+size_t circular_buffer_write_reserve_policy(circular_buffer *cb, size_t length, circular_buffer_spans *spans);
+
+/**
+ * @brief 获取环形缓冲区内全部可读数据的只读视图（零拷贝读取）
+ *
+ * spans返回最多两段位于缓冲区内部的可读内存，调用者可以直接解析、校验
+ * 或交给writev等接口使用，之后通过circular_buffer_consume释放已处理的部分。
+ * 视图中的数据不得修改。启用锁时，返回值大于0时锁保持持有，直到调用
+ * circular_buffer_consume才释放，因此两者必须成对调用，且中间不能再调用本缓冲区的其他接口。
+ *
+ * @param cb 环形缓冲区结构体指针
+ * @param spans 返回的可读内存段
+ * @return 可读数据总长度，为0时表示缓冲区为空且无需调用circular_buffer_consume
+ */
+size_t circular_buffer_peek_spans(circular_buffer *cb, circular_buffer_spans *spans);
+
+/**
+ * @brief 消费通过circular_buffer_peek_spans获取的数据
+ *
+ * 只移动start，不拷贝数据，length为0表示不消费任何数据。
+ * 关闭锁的覆盖旧数据策略下，写入端可能在调用者访问期间覆盖这段数据，
+ * 此时返回false，调用者应当丢弃读到的内容，下一次peek从最早的有效数据开始。
+ *
+ * @param cb 环形缓冲区结构体指针
+ * @param length 消费的长度，不能超过circular_buffer_peek_spans返回的长度
+ * @return 成功返回true，超过可读长度或数据已被覆盖返回false（此时不消费任何数据）
+ */
+bool circular_buffer_consume(circular_buffer *cb, size_t length);
+
+/**
+ * @brief 写入一条消息（消息模式）
+ *
+ * 消息模式以记录为单位读写：每条记录由4字节长度头和负载组成，按4字节对齐，
+ * 长度头和负载在一次加锁、一次end发布中写入，读取端只会看到完整的消息。
+ * 多生产者模式下同样可用，记录通过CAS认领后并行写入、按序发布。
+ * 消息接口不受写入策略影响，空间不足时总是拒绝；同一个缓冲区不能混用消息接口和字节接口。
+ * 单条消息的负载不超过size减去长度头（保持记录连续时为size / 2减去长度头）。
+ *
+ * 图示（size = 16，写入3字节和5字节的两条消息）:
+ * start
+ *  |
+ * [3][0][0][0][a][b][c][ ][5][0][0][0][d][e][f][g]  ->  环绕，[h]在缓冲区起始位置
+ *  |__长度头__|__负载__|填充|
+ *
+ * @param cb 环形缓冲区结构体指针
+ * @param data 负载指针
+ * @param length 负载长度，可以为0
+ * @return 成功返回true，剩余空间不足或消息过长返回false
+ */
+bool circular_buffer_push_msg(circular_buffer *cb, const void *data, size_t length);
+
+/**
+ * @brief 读取一条完整的消息（消息模式）
+ *
+ * capacity小于消息长度时不读取，消息保留在缓冲区中，length返回所需的长度。
+ *
+ * @param cb 环形缓冲区结构体指针
+ * @param data 负载的目标缓冲区
+ * @param capacity 目标缓冲区的大小
+ * @param length 返回负载长度；缓冲区为空时返回0
+ * @return 成功返回true，缓冲区为空或capacity不足返回false
+ */
+bool circular_buffer_pop_msg(circular_buffer *cb, void *data, size_t capacity, size_t *length);
+
+/**
+ * @brief 获取第一条消息负载的只读视图（消息模式的零拷贝读取）
+ *
+ * spans返回负载所在的最多两段内存（指定CIRCULAR_BUFFER_FLAG_CONTIGUOUS_MSG或镜像映射时只有一段），
+ * 负载长度为各段长度之和，处理完后调用circular_buffer_consume_msg释放整条消息。
+ * 与circular_buffer_peek_spans相同，返回true时锁保持持有，两者必须成对调用。
+ *
+ * @param cb 环形缓冲区结构体指针
+ * @param spans 返回负载所在的内存段
+ * @return 有消息返回true，缓冲区为空返回false（无需调用circular_buffer_consume_msg）
+ */
+bool circular_buffer_peek_msg(circular_buffer *cb, circular_buffer_spans *spans);
+
+/**
+ * @brief 消费通过circular_buffer_peek_msg获取的消息
+ *
+ * @param cb 环形缓冲区结构体指针
+ */
+void circular_buffer_consume_msg(circular_buffer *cb);
+
 /**
  * @brief 获取环形缓冲区中的有效数据长度
  *
+ * 状态查询（本函数、circular_buffer_is_empty、circular_buffer_is_full）不获取互斥锁，
+ * 在任何锁配置下都只对start和end做原子读取，可以被监控线程高频轮询。
+ * 没有并发读写时结果是精确的；读写端并发推进时，结果是调用期间某一时刻附近的快照：
+ * 先读start再读end，结果总在0到size之间，但可能已经过时，
+ * 只能作为调度提示，不能代替读写接口的返回值判断空满。
+ *
  * @param cb 环形缓冲区结构体指针
  * @return 有效数据长度
  */
@@ -68,6 +499,8 @@ size_t circular_buffer_length(circular_buffer *cb);
 /**
  * @brief 检查环形缓冲区是否为空
  *
+ * 不获取互斥锁，快照语义见circular_buffer_length。
+ *
  * @param cb 环形缓冲区结构体指针
  * @return 为空返回true，不为空返回false
  */
@@ -76,6 +509,8 @@ bool circular_buffer_is_empty(circular_buffer *cb);
 /**
  * @brief 检查环形缓冲区是否已满
  *
+ * 不获取互斥锁，快照语义见circular_buffer_length。
+ *
  * @param cb 环形缓冲区结构体指针
  * @return 已满返回true，未满返回false
  */
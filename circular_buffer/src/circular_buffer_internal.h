@@ -0,0 +1,116 @@
+// circular_buffer_internal.h
+#ifndef CIRCULAR_BUFFER_INTERNAL_H
+#define CIRCULAR_BUFFER_INTERNAL_H
+
+// 库内部共用的辅助函数，不属于对外接口
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "circular_buffer.h"
+
+/**
+ * @brief 检查是否为2的幂
+ *
+ * @param size 待检查的大小
+ * @return 是2的幂返回true，否则返回false
+ */
+static inline bool is_power_of_two(size_t size)
+{
+    // 检查size是否为2的幂次
+    // 2的幂次在二进制表示中只有一个1，其余位都是0
+    // 例如，4的二进制表示是100，8的二进制表示是1000
+
+    // 首先检查size是否不为0
+    // 如果size为0，则不是2的幂次，因为2的任何幂都不可能为0
+    // 所以我们需要确保size不为0
+
+    // 现在考虑size为非0的情况
+    // 利用位操作来检查size是否是2的幂次
+    // 具体来说，我们使用表达式 (size & (size - 1)) == 0
+    // 其原理如下：
+
+    // 对于一个数size，如果它是2的幂次，例如4 (100) 或8 (1000)
+    // 它的二进制表示中只有一个1，其余位都是0
+
+    // 当我们从size中减去1时
+    // 例如，4 - 1 = 3，二进制表示为100 - 1 = 011
+    // 或者8 - 1 = 7，二进制表示为1000 - 1 = 0111
+
+    // 减1操作会将size的二进制表示中的最低位的1变为0
+    // 并将这个1右边的所有0变为1
+
+    // 现在，考虑按位与操作 size & (size - 1)
+    // 对于4：100 & 011 = 000
+    // 对于8：1000 & 0111 = 0000
+
+    // 可以看到，如果size是2的幂次，size & (size - 1) 的结果必然是0
+    // 因为在减去1之后，最低位的1被清除了，且没有其他相同的位会保留1
+
+    // 如果size不是2的幂次，例如5 (101)
+    // 5 - 1 = 4，二进制表示为101 - 1 = 100
+    // size & (size - 1) = 101 & 100 = 100
+    // 结果不为0，因为原来的最低位的1并没有被清除
+
+    // 因此，通过检查 (size & (size - 1)) == 0
+    // 我们可以判断size是否是2的幂次
+    return (size != 0) && ((size & (size - 1)) == 0);
+}
+
+/**
+ * @brief 获取缓冲区数据区的起始地址
+ *
+ * 共享内存段在各进程中的映射地址不同，不能保存指针，数据区通过结构体自身地址加偏移定位，
+ * 此时cb->buffer为NULL，需要数据区地址的地方都应通过此函数获取。
+ *
+ * @param cb 环形缓冲区结构体指针
+ * @return 数据区起始地址
+ */
+static inline char *circular_buffer_data_base(const circular_buffer *cb)
+{
+    if (cb->flags & CIRCULAR_BUFFER_FLAG_SHARED)
+    {
+        return (char *)cb + cb->data_offset;
+    }
+    return cb->buffer;
+}
+
+/**
+ * @brief 在共享内存段中初始化环形缓冲区，供circular_buffer_create_shared使用
+ *
+ * 设置CIRCULAR_BUFFER_FLAG_SHARED：数据区以偏移而不是指针记录，锁和等待按跨进程方式初始化。
+ * 不支持多生产者模式和镜像映射，大页和NUMA提示被忽略。
+ *
+ * @param cb 环形缓冲区结构体指针，位于共享内存段中
+ * @param size 缓冲区大小（必须为2的幂次）
+ * @param data_offset 数据区相对cb的偏移，数据区至少size字节
+ * @param options 初始化选项，可以为NULL
+ * @return 成功返回true，失败返回false
+ */
+bool circular_buffer_init_shared(circular_buffer *cb, size_t size, size_t data_offset,
+                                 const circular_buffer_options *options);
+
+/**
+ * @brief 在生产者锁内预留end之后的全部剩余空间（零拷贝写入）
+ *
+ * 剩余空间在持锁之后计算，其他写入端并发写入只会让预留变小，不会导致预留失败；
+ * 预留成功后锁保持持有，直到调用circular_buffer_write_commit。不支持多生产者模式。
+ *
+ * @param cb 环形缓冲区结构体指针
+ * @param spans 返回的可写内存段
+ * @return 预留的长度，缓冲区已满或为多生产者模式时返回0（此时无需提交）
+ */
+size_t circular_buffer_write_reserve_available(circular_buffer *cb, circular_buffer_spans *spans);
+
+/**
+ * @brief 重新打开共享内存段或文件中已有的环形缓冲区
+ *
+ * 保留start、end、写入策略和数据，重新初始化锁、等待标志和预留状态，
+ * 上一次打开时尚未发布的写入被丢弃。
+ *
+ * @param cb 环形缓冲区结构体指针，位于映射中
+ * @param data_offset 数据区相对cb的偏移
+ * @return 成功返回true，索引不一致或初始化失败返回false
+ */
+bool circular_buffer_reopen_shared(circular_buffer *cb, size_t data_offset);
+
+#endif // CIRCULAR_BUFFER_INTERNAL_H
@@ -0,0 +1,120 @@
+// circular_buffer_io.c
+#include "circular_buffer_io.h"
+#include "circular_buffer_internal.h"
+#include <errno.h>
+
+#if defined(PLATFORM_LINUX)
+#include <sys/uio.h>
+
+/**
+ * @brief 将环形缓冲区的连续内存段转换为readv/writev使用的iovec数组
+ *
+ * @param spans 连续内存段
+ * @param iov 返回的iovec数组，至少两个元素
+ * @return iovec的个数
+ */
+static int spans_to_iovec(const circular_buffer_spans *spans, struct iovec *iov)
+{
+    for (size_t i = 0; i < spans->count; i++)
+    {
+        iov[i].iov_base = spans->span[i].data;
+        iov[i].iov_len = spans->span[i].length;
+    }
+    return (int)spans->count;
+}
+
+/**
+ * @brief 从文件描述符读取数据，直接写入环形缓冲区
+ *
+ * @param cb 环形缓冲区结构体指针
+ * @param fd 文件描述符
+ * @return 读取的字节数，0表示EOF，-1表示出错
+ */
+ssize_t circular_buffer_fill_from_fd(circular_buffer *cb, int fd)
+{
+    if (cb->flags & CIRCULAR_BUFFER_FLAG_MULTI_PRODUCER)
+    {
+        errno = ENOTSUP;
+        return -1;
+    }
+    // 剩余空间在生产者锁内计算，并发的写入端不会让预留失败，只有缓冲区确实已满时才返回ENOBUFS
+    circular_buffer_spans spans;
+    if (circular_buffer_write_reserve_available(cb, &spans) == 0)
+    {
+        errno = ENOBUFS;
+        return -1;
+    }
+
+    // 环绕点前后两段空间在一次readv中填充
+    // 图示:
+    //       end           start
+    //        |              |
+    // [ ][ ][ ][ ][ ][ ][ ][X][X][ ][ ]   ->  iov[0] = [end, 环绕点)，iov[1] = [0, start)
+    struct iovec iov[2];
+    int count = spans_to_iovec(&spans, iov);
+    ssize_t n;
+    do
+    {
+        n = readv(fd, iov, count);
+    } while (n < 0 && errno == EINTR);
+
+    int saved_errno = errno;
+    circular_buffer_write_commit(cb, (n > 0) ? (size_t)n : 0); // 只发布实际读到的部分
+    errno = saved_errno;
+    return n;
+}
+
+/**
+ * @brief 将环形缓冲区中的数据直接写入文件描述符
+ *
+ * @param cb 环形缓冲区结构体指针
+ * @param fd 文件描述符
+ * @return 写出的字节数，缓冲区为空时返回0，-1表示出错
+ */
+ssize_t circular_buffer_drain_to_fd(circular_buffer *cb, int fd)
+{
+#if !ENABLE_LOCK
+    if (cb->policy == CIRCULAR_BUFFER_POLICY_OVERWRITE)
+    {
+        // 无锁覆盖模式下写入端可能在writev期间套圈，被改写的数据在consume发现之前已经写出
+        errno = ENOTSUP;
+        return -1;
+    }
+#endif
+    circular_buffer_spans spans;
+    if (circular_buffer_peek_spans(cb, &spans) == 0)
+    {
+        return 0; // 缓冲区为空，peek_spans已经释放锁
+    }
+
+    struct iovec iov[2];
+    int count = spans_to_iovec(&spans, iov);
+    ssize_t n;
+    do
+    {
+        n = writev(fd, iov, count);
+    } while (n < 0 && errno == EINTR);
+
+    int saved_errno = errno;
+    circular_buffer_consume(cb, (n > 0) ? (size_t)n : 0); // 只释放实际写出的部分
+    errno = saved_errno;
+    return n;
+}
+#else
+ssize_t circular_buffer_fill_from_fd(circular_buffer *cb, int fd)
+{
+    // 该平台没有readv
+    (void)cb;
+    (void)fd;
+    errno = ENOTSUP;
+    return -1;
+}
+
+ssize_t circular_buffer_drain_to_fd(circular_buffer *cb, int fd)
+{
+    (void)cb;
+    (void)fd;
+    errno = ENOTSUP;
+    return -1;
+}
+#endif
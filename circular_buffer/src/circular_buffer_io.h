@@ -0,0 +1,45 @@
+// circular_buffer_io.h
+#ifndef CIRCULAR_BUFFER_IO_H
+#define CIRCULAR_BUFFER_IO_H
+
+#include <sys/types.h>
+#include "circular_buffer.h"
+
+/**
+ * @brief 从文件描述符读取数据，直接写入环形缓冲区
+ *
+ * 以写入端身份预留全部剩余空间（在生产者锁内计算，可以与其他线程的circular_buffer_write并发调用），
+ * 对其中（最多两段）连续区域发起一次readv，
+ * 按系统调用返回的字节数推进end，数据不经过中间数组。被信号中断时自动重试。
+ * 调用期间持有生产者锁，阻塞的文件描述符会在读到数据前一直占用锁，
+ * 读写共用一把锁时同时阻塞读取端，建议使用非阻塞文件描述符或读写分离锁。
+ * 多生产者模式下不支持（circular_buffer_write_reserve不可用），返回-1并置errno为ENOTSUP。
+ * 仅Linux平台支持。
+ *
+ * @param cb 环形缓冲区结构体指针
+ * @param fd 文件描述符，可以是非阻塞的
+ * @return 读取的字节数；0表示对端关闭（EOF）；
+ *         -1表示出错，errno为EAGAIN/EWOULDBLOCK（非阻塞且暂无数据）、
+ *         ENOBUFS（环形缓冲区已满）或readv返回的其他错误，出错时缓冲区不变
+ */
+ssize_t circular_buffer_fill_from_fd(circular_buffer *cb, int fd);
+
+/**
+ * @brief 将环形缓冲区中的数据直接写入文件描述符
+ *
+ * 以读取端身份获取全部可读数据，对其中（最多两段）连续区域发起一次writev，
+ * 按系统调用返回的字节数推进start，未写出的数据留在缓冲区中等待下次调用。被信号中断时自动重试。
+ * 调用期间持有消费者锁，阻塞注意事项与circular_buffer_fill_from_fd相同。
+ * 无锁覆盖模式下写入端可能在writev期间覆盖正在发送的数据，不支持，返回-1并置errno为ENOTSUP。
+ * 仅Linux平台支持。
+ *
+ * @param cb 环形缓冲区结构体指针
+ * @param fd 文件描述符，可以是非阻塞的
+ * @return 写出的字节数，缓冲区为空时返回0；
+ *         -1表示出错，errno为EAGAIN/EWOULDBLOCK（非阻塞且暂时无法写入）、ENOTSUP（无锁覆盖模式）
+ *         或writev返回的其他错误，
+ *         出错时缓冲区不变
+ */
+ssize_t circular_buffer_drain_to_fd(circular_buffer *cb, int fd);
+
+#endif // CIRCULAR_BUFFER_IO_H
@@ -0,0 +1,162 @@
+// circular_buffer_mpmc.c
+#include "circular_buffer_mpmc.h"
+#include "circular_buffer_internal.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief 获取位置pos对应的槽位序号
+ *
+ * @param q 队列结构体指针
+ * @param pos 自由增长的位置计数器，通过掩码capacity-1映射到槽位
+ * @return 槽位序号指针，元素数据紧跟在序号之后
+ */
+static atomic_size_t *slot_at(const circular_buffer_mpmc *q, size_t pos)
+{
+    return (atomic_size_t *)(q->slots + (pos & (q->capacity - 1)) * q->slot_size);
+}
+
+/**
+ * @brief 初始化多生产者多消费者队列
+ *
+ * @param q 队列结构体指针
+ * @param capacity 槽位数量（必须为2的幂次且不小于2）
+ * @param element_size 单个元素的字节数（不能为0）
+ * @return 成功返回true，失败返回false
+ */
+bool circular_buffer_mpmc_init(circular_buffer_mpmc *q, size_t capacity, size_t element_size)
+{
+    // 与circular_buffer相同，要求容量为2的幂次，位置到槽位的映射只需一次按位与
+    // 容量为1时，入队后的序号pos + 1恰好等于下一次入队的位置，槽位会被误判为可写
+    if (capacity < 2 || !is_power_of_two(capacity) || element_size == 0)
+    {
+        return false;
+    }
+    // 槽位 = 序号 + 元素，向上取整到序号的对齐要求，保证每个槽位的序号都正确对齐
+    size_t align = _Alignof(atomic_size_t);
+    if (element_size > SIZE_MAX - sizeof(atomic_size_t) - (align - 1))
+    {
+        return false; // 槽位大小溢出
+    }
+    q->slot_size = (sizeof(atomic_size_t) + element_size + align - 1) & ~(align - 1);
+    if (capacity > SIZE_MAX / q->slot_size)
+    {
+        return false; // 槽位总大小溢出，malloc会得到一块过小的内存
+    }
+    q->capacity = capacity;
+    q->element_size = element_size;
+    q->slots = (char *)malloc(capacity * q->slot_size);
+    if (q->slots == NULL)
+    {
+        return false;
+    }
+    // 初始时槽位i的序号为i，即第一圈的每个入队位置都可写
+    for (size_t i = 0; i < capacity; i++)
+    {
+        atomic_init(slot_at(q, i), i);
+    }
+    atomic_init(&q->enqueue_pos, 0);
+    atomic_init(&q->dequeue_pos, 0);
+    return true;
+}
+
+/**
+ * @brief 释放队列资源
+ *
+ * @param q 队列结构体指针
+ */
+void circular_buffer_mpmc_free(circular_buffer_mpmc *q)
+{
+    free(q->slots);
+    q->slots = NULL;
+    q->capacity = 0;
+}
+
+/**
+ * @brief 入队一个元素
+ *
+ * @param q 队列结构体指针
+ * @param element 元素指针，拷贝element_size个字节
+ * @return 成功返回true，队列已满返回false
+ */
+bool circular_buffer_mpmc_enqueue(circular_buffer_mpmc *q, const void *element)
+{
+    size_t pos = atomic_load_explicit(&q->enqueue_pos, memory_order_relaxed);
+    atomic_size_t *slot;
+    for (;;)
+    {
+        slot = slot_at(q, pos);
+        // acquire读取序号，与出队时的release配对，保证上一圈的元素已经被读走
+        size_t seq = atomic_load_explicit(slot, memory_order_acquire);
+        intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+        if (diff == 0)
+        {
+            // 槽位可写，通过CAS认领位置pos；失败时pos被更新为最新的入队位置
+            if (atomic_compare_exchange_weak_explicit(&q->enqueue_pos, &pos, pos + 1, memory_order_relaxed,
+                                                      memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if (diff < 0)
+        {
+            // 序号仍停留在上一圈（pos - capacity + 1），槽位中的元素尚未出队，队列已满
+            return false;
+        }
+        else
+        {
+            // 其他生产者已经认领了这个位置，重新读取入队位置
+            pos = atomic_load_explicit(&q->enqueue_pos, memory_order_relaxed);
+        }
+    }
+
+    memcpy((char *)(slot + 1), element, q->element_size);
+    // release发布序号pos + 1，消费者acquire读取到该序号时元素已经完整写入
+    atomic_store_explicit(slot, pos + 1, memory_order_release);
+    return true;
+}
+
+/**
+ * @brief 出队一个元素
+ *
+ * @param q 队列结构体指针
+ * @param element 元素指针，拷贝出element_size个字节
+ * @return 成功返回true，队列为空返回false
+ */
+bool circular_buffer_mpmc_dequeue(circular_buffer_mpmc *q, void *element)
+{
+    size_t pos = atomic_load_explicit(&q->dequeue_pos, memory_order_relaxed);
+    atomic_size_t *slot;
+    for (;;)
+    {
+        slot = slot_at(q, pos);
+        // acquire读取序号，与入队时的release配对，保证元素已经完整写入
+        size_t seq = atomic_load_explicit(slot, memory_order_acquire);
+        intptr_t diff = (intptr_t)seq - (intptr_t)(pos + 1);
+        if (diff == 0)
+        {
+            // 槽位可读，通过CAS认领位置pos；失败时pos被更新为最新的出队位置
+            if (atomic_compare_exchange_weak_explicit(&q->dequeue_pos, &pos, pos + 1, memory_order_relaxed,
+                                                      memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if (diff < 0)
+        {
+            // 序号仍为pos，元素尚未写入，队列为空
+            return false;
+        }
+        else
+        {
+            // 其他消费者已经认领了这个位置，重新读取出队位置
+            pos = atomic_load_explicit(&q->dequeue_pos, memory_order_relaxed);
+        }
+    }
+
+    memcpy(element, (const char *)(slot + 1), q->element_size);
+    // release发布序号pos + capacity，槽位留给下一圈位置为pos + capacity的入队
+    atomic_store_explicit(slot, pos + q->capacity, memory_order_release);
+    return true;
+}
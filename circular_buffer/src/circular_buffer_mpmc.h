@@ -0,0 +1,77 @@
+// circular_buffer_mpmc.h
+#ifndef CIRCULAR_BUFFER_MPMC_H
+#define CIRCULAR_BUFFER_MPMC_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "circular_buffer.h"
+
+/**
+ * @brief 多生产者多消费者定长元素队列
+ *
+ * 与按字节读写的circular_buffer不同，队列以定长元素为单位，每个槽位带有一个序号：
+ * 序号等于入队位置pos时槽位可写，等于pos + 1时槽位可读，
+ * 出队后序号被设置为pos + capacity，表示槽位可供下一圈的入队使用。
+ * 入队和出队各自只需一次针对自己游标的CAS加一次槽位序号检查，不使用互斥锁，
+ * 任意数量的生产者和消费者可以同时访问，与ENABLE_LOCK的设置无关。
+ *
+ * 图示（capacity = 4，已入队2个元素，已出队1个元素）:
+ *  dequeue_pos = 1      enqueue_pos = 2
+ *       |                    |
+ * 槽位: [0]     [1]     [2]     [3]
+ * 序号:  4       2       2       3
+ *      可写     可读     可写    可写
+ *     (下一圈)
+ */
+typedef struct
+{
+    // 只读区：初始化后不再修改
+    size_t capacity;     /**< 槽位数量（必须为2的幂次） */
+    size_t element_size; /**< 单个元素的字节数 */
+    size_t slot_size;    /**< 单个槽位的字节数，包括序号和元素并按序号对齐 */
+    char *slots;         /**< 槽位数组 */
+
+    // 生产者区与消费者区分开放置，避免两侧游标的伪共享
+    CIRCULAR_BUFFER_CACHE_ALIGNED atomic_size_t enqueue_pos; /**< 下一个入队位置，生产者之间通过CAS竞争 */
+    CIRCULAR_BUFFER_CACHE_ALIGNED atomic_size_t dequeue_pos; /**< 下一个出队位置，消费者之间通过CAS竞争 */
+} circular_buffer_mpmc;
+
+/**
+ * @brief 初始化多生产者多消费者队列
+ *
+ * @param q 队列结构体指针
+ * @param capacity 槽位数量（必须为2的幂次且不小于2）
+ * @param element_size 单个元素的字节数（不能为0）
+ * @return 成功返回true，失败返回false
+ */
+bool circular_buffer_mpmc_init(circular_buffer_mpmc *q, size_t capacity, size_t element_size);
+
+/**
+ * @brief 释放队列资源
+ *
+ * @param q 队列结构体指针
+ */
+void circular_buffer_mpmc_free(circular_buffer_mpmc *q);
+
+/**
+ * @brief 入队一个元素
+ *
+ * @param q 队列结构体指针
+ * @param element 元素指针，拷贝element_size个字节
+ * @return 成功返回true，队列已满返回false
+ */
+bool circular_buffer_mpmc_enqueue(circular_buffer_mpmc *q, const void *element);
+
+/**
+ * @brief 出队一个元素
+ *
+ * 队首元素已被生产者认领但尚未写完时同样返回false，调用者稍后重试即可。
+ *
+ * @param q 队列结构体指针
+ * @param element 元素指针，拷贝出element_size个字节
+ * @return 成功返回true，队列为空返回false
+ */
+bool circular_buffer_mpmc_dequeue(circular_buffer_mpmc *q, void *element);
+
+#endif // CIRCULAR_BUFFER_MPMC_H
@@ -0,0 +1,454 @@
+// circular_buffer_shared.c
+#define _GNU_SOURCE
+#include "circular_buffer_shared.h"
+#include "circular_buffer_internal.h"
+#include <stdatomic.h>
+#include <stdint.h>
+
+#if defined(PLATFORM_LINUX)
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// 段头魔数"CBSH"
+#define SHARED_MAGIC  (0x43425348u)
+// 结构体大小和影响布局的编译配置，两个进程的二进制必须一致才能共享同一个段
+#define SHARED_LAYOUT                                                                                    \
+    ((uint32_t)sizeof(circular_buffer) | ((uint32_t)ENABLE_LOCK << 24) |                                 \
+     ((uint32_t)CIRCULAR_BUFFER_USE_SPLIT_LOCK << 25) | ((uint32_t)CIRCULAR_BUFFER_SEPARATE_INDEX << 26))
+
+/**
+ * @brief 共享内存段的布局，段内不保存任何指针
+ *
+ * 图示:
+ * 0                                              data_start（按页对齐）           segment_size
+ * |[magic][layout][segment_size][ready][circular_buffer]   ...   |[        数据区（size字节）        ]|
+ *                                       |<---------- ring.data_offset ---------->|
+ */
+typedef struct
+{
+    uint32_t magic;        /**< SHARED_MAGIC */
+    uint32_t layout;       /**< 创建者的SHARED_LAYOUT */
+    uint64_t segment_size; /**< 整个段的字节数 */
+    atomic_uint ready;     /**< 创建者初始化完成后以release置1 */
+    circular_buffer ring;  /**< 环形缓冲区，数据区位于段内data_start处 */
+} shared_segment;
+
+/**
+ * @brief 由环形缓冲区指针得到所在的共享内存段
+ *
+ * @param cb 环形缓冲区结构体指针
+ * @return 段头指针
+ */
+static shared_segment *segment_of(circular_buffer *cb)
+{
+    return (shared_segment *)((char *)cb - offsetof(shared_segment, ring));
+}
+
+/**
+ * @brief 计算数据区在段内的起始偏移：段头之后按页对齐
+ *
+ * @return 数据区起始偏移
+ */
+static size_t segment_data_start(void)
+{
+    size_t page_size = (size_t)sysconf(_SC_PAGESIZE);
+    return (sizeof(shared_segment) + page_size - 1) & ~(page_size - 1);
+}
+
+/**
+ * @brief 在新映射的段中写入段头并初始化环形缓冲区，完成后以release置ready
+ *
+ * @param segment 段头指针
+ * @param size 缓冲区大小
+ * @param data_start 数据区在段内的起始偏移
+ * @param options 初始化选项，可以为NULL
+ * @return 成功返回true，失败返回false
+ */
+static bool segment_init(shared_segment *segment, size_t size, size_t data_start, const circular_buffer_options *options)
+{
+    segment->magic = SHARED_MAGIC;
+    segment->layout = SHARED_LAYOUT;
+    segment->segment_size = data_start + size;
+    if (!circular_buffer_init_shared(&segment->ring, size, data_start - offsetof(shared_segment, ring), options))
+    {
+        return false;
+    }
+    atomic_store_explicit(&segment->ready, 1, memory_order_release);
+    return true;
+}
+
+/**
+ * @brief 创建跨进程共享的环形缓冲区
+ *
+ * @param name 共享内存段名称
+ * @param size 缓冲区大小（必须为2的幂次）
+ * @param options 初始化选项，可以为NULL
+ * @return 成功返回环形缓冲区指针，失败返回NULL
+ */
+circular_buffer *circular_buffer_create_shared(const char *name, size_t size, const circular_buffer_options *options)
+{
+    size_t data_start = segment_data_start();
+    if (size == 0 || size > SIZE_MAX - data_start)
+    {
+        return NULL;
+    }
+    size_t segment_size = data_start + size;
+
+    // O_EXCL：不会误把其他进程正在使用的段重新初始化
+    int fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0)
+    {
+        return NULL;
+    }
+    void *base = MAP_FAILED;
+    if (ftruncate(fd, (off_t)segment_size) == 0)
+    {
+        base = mmap(NULL, segment_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    close(fd); // 映射建立后不再需要文件描述符
+    if (base == MAP_FAILED)
+    {
+        shm_unlink(name);
+        return NULL;
+    }
+
+    // ftruncate扩展出的内容为0，ready在初始化完成前保持为0，attach会拒绝半初始化的段
+    shared_segment *segment = (shared_segment *)base;
+    if (!segment_init(segment, size, data_start, options))
+    {
+        munmap(base, segment_size);
+        shm_unlink(name);
+        return NULL;
+    }
+    return &segment->ring;
+}
+
+/**
+ * @brief 映射已经由其他进程创建的共享环形缓冲区
+ *
+ * @param name 共享内存段名称
+ * @return 成功返回环形缓冲区指针，失败返回NULL
+ */
+circular_buffer *circular_buffer_attach_shared(const char *name)
+{
+    int fd = shm_open(name, O_RDWR, 0);
+    if (fd < 0)
+    {
+        return NULL;
+    }
+    struct stat st;
+    void *base = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && (size_t)st.st_size >= sizeof(shared_segment))
+    {
+        base = mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    if (base == MAP_FAILED)
+    {
+        return NULL;
+    }
+
+    // acquire读取ready，与创建者的release配对，保证看到完整初始化的结构体
+    shared_segment *segment = (shared_segment *)base;
+    if (atomic_load_explicit(&segment->ready, memory_order_acquire) != 1 || segment->magic != SHARED_MAGIC ||
+        segment->layout != SHARED_LAYOUT || segment->segment_size != (uint64_t)st.st_size)
+    {
+        munmap(base, (size_t)st.st_size);
+        return NULL;
+    }
+    return &segment->ring;
+}
+
+/**
+ * @brief 解除当前进程对共享环形缓冲区的映射
+ *
+ * @param cb 环形缓冲区指针
+ */
+void circular_buffer_detach_shared(circular_buffer *cb)
+{
+    shared_segment *segment = segment_of(cb);
+    munmap(segment, (size_t)segment->segment_size);
+}
+
+/**
+ * @brief 删除共享内存段的名称
+ *
+ * @param name 共享内存段名称
+ * @return 成功返回true，失败返回false
+ */
+bool circular_buffer_unlink_shared(const char *name)
+{
+    return shm_unlink(name) == 0;
+}
+/**
+ * @brief 同步段内的一段范围，起点向下对齐到页
+ *
+ * @param segment 段头指针
+ * @param offset 范围在段内的起始偏移
+ * @param length 范围长度
+ * @return 成功返回true，msync失败返回false
+ */
+static bool sync_range(shared_segment *segment, size_t offset, size_t length)
+{
+    size_t page_size = (size_t)sysconf(_SC_PAGESIZE);
+    size_t begin = offset & ~(page_size - 1);
+    return msync((char *)segment + begin, offset + length - begin, MS_SYNC) == 0;
+}
+
+/**
+ * @brief 打开以文件为存储的持久化环形缓冲区，文件不存在时创建
+ *
+ * @param p 持久化环形缓冲区结构体指针
+ * @param path 文件路径
+ * @param size 缓冲区大小（必须为2的幂次）
+ * @param options 初始化选项，可以为NULL
+ * @param policy msync批量策略，可以为NULL
+ * @return 成功返回true，失败返回false
+ */
+bool circular_buffer_open_persistent(circular_buffer_persistent *p, const char *path, size_t size,
+                                     const circular_buffer_options *options,
+                                     const circular_buffer_persist_policy *policy)
+{
+    size_t data_start = segment_data_start();
+    if (size == 0 || size > SIZE_MAX - data_start)
+    {
+        return false;
+    }
+    size_t segment_size = data_start + size;
+
+    int fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+    if (fd < 0)
+    {
+        return false;
+    }
+    // 重新打开会重置锁，两个进程同时打开同一文件会破坏对方持有的锁，因此独占打开
+    struct stat st;
+    if (flock(fd, LOCK_EX | LOCK_NB) != 0 || fstat(fd, &st) != 0)
+    {
+        close(fd);
+        return false;
+    }
+    // 空文件为新建；已有文件的大小必须与本次调用一致，否则不改动文件直接失败
+    bool fresh = (st.st_size == 0);
+    if ((fresh && ftruncate(fd, (off_t)segment_size) != 0) || (!fresh && (size_t)st.st_size != segment_size))
+    {
+        close(fd);
+        return false;
+    }
+    void *base = mmap(NULL, segment_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (base == MAP_FAILED)
+    {
+        close(fd);
+        return false;
+    }
+
+    shared_segment *segment = (shared_segment *)base;
+    bool ok;
+    if (fresh || atomic_load_explicit(&segment->ready, memory_order_acquire) != 1)
+    {
+        // 新文件，或上次创建时在初始化完成前崩溃，文件中没有需要保留的数据
+        ok = segment_init(segment, size, data_start, options) && sync_range(segment, 0, data_start);
+    }
+    else
+    {
+        // 布局不一致（编译配置不同）的文件不能按本进程的结构体解释
+        ok = segment->magic == SHARED_MAGIC && segment->layout == SHARED_LAYOUT &&
+             segment->segment_size == (uint64_t)segment_size &&
+             circular_buffer_reopen_shared(&segment->ring, data_start - offsetof(shared_segment, ring));
+    }
+    if (!ok)
+    {
+        munmap(base, segment_size);
+        close(fd);
+        return false;
+    }
+
+    p->cb = &segment->ring;
+    p->fd = fd;
+    if (policy != NULL)
+    {
+        p->policy = *policy;
+    }
+    else
+    {
+        p->policy.sync_bytes = 0;
+        p->policy.sync_interval_ms = 0;
+    }
+    // 打开时的内容视为已经落盘：新文件刚刚同步过段头，重新打开的内容来自磁盘或上次进程留下的页缓存
+    p->synced_start = atomic_load_explicit(&p->cb->start, memory_order_relaxed);
+    p->synced_end = atomic_load_explicit(&p->cb->end, memory_order_relaxed);
+    p->synced_ms = time_now_ms();
+    return true;
+}
+
+/**
+ * @brief 写入数据，并按批量策略决定是否刷盘
+ *
+ * @param p 持久化环形缓冲区结构体指针
+ * @param data 数据指针
+ * @param length 数据长度
+ * @return 写入成功返回true，空间不足返回false
+ */
+bool circular_buffer_write_persistent(circular_buffer_persistent *p, const char *data, size_t length)
+{
+    if (!circular_buffer_write(p->cb, data, length))
+    {
+        return false;
+    }
+    (void)circular_buffer_poll_persistent(p);
+    return true;
+}
+
+/**
+ * @brief 按批量策略检查是否需要刷盘，需要时同步
+ *
+ * @param p 持久化环形缓冲区结构体指针
+ * @return 无需同步或同步成功返回true，msync失败返回false
+ */
+bool circular_buffer_poll_persistent(circular_buffer_persistent *p)
+{
+    size_t end = atomic_load_explicit(&p->cb->end, memory_order_relaxed);
+    size_t start = atomic_load_explicit(&p->cb->start, memory_order_relaxed);
+    if (end == p->synced_end && start == p->synced_start)
+    {
+        return true; // 没有新的写入或读取
+    }
+    // 先比较字节数，不满足时才读取时钟
+    bool due = (p->policy.sync_bytes != 0 && end - p->synced_end >= p->policy.sync_bytes) ||
+               (p->policy.sync_interval_ms != 0 && time_now_ms() - p->synced_ms >= p->policy.sync_interval_ms);
+    return due ? circular_buffer_sync_persistent(p) : true;
+}
+
+/**
+ * @brief 立即把上次同步以来写入的数据和段头刷到磁盘
+ *
+ * @param p 持久化环形缓冲区结构体指针
+ * @return 成功返回true，msync失败返回false
+ */
+bool circular_buffer_sync_persistent(circular_buffer_persistent *p)
+{
+    circular_buffer *cb = p->cb;
+    shared_segment *segment = segment_of(cb);
+    size_t data_start = (size_t)((char *)cb + cb->data_offset - (char *)segment);
+    // acquire读取end，保证其之前提交的数据已经写入映射
+    size_t end = atomic_load_explicit(&cb->end, memory_order_acquire);
+    size_t start = atomic_load_explicit(&cb->start, memory_order_relaxed);
+    size_t dirty = end - p->synced_end;
+    bool ok = true;
+
+    // 只同步上次同步以来新写入的范围，跨越缓冲区末尾时分两段:
+    // |[ 第二段 ]...........[ 第一段 ]|
+    //           ^end        ^synced_end
+    if (dirty >= cb->size)
+    {
+        ok = sync_range(segment, data_start, cb->size);
+    }
+    else if (dirty > 0)
+    {
+        size_t offset = p->synced_end & (cb->size - 1);
+        size_t first = (dirty < cb->size - offset) ? dirty : cb->size - offset;
+        ok = sync_range(segment, data_start + offset, first);
+        if (ok && dirty > first)
+        {
+            ok = sync_range(segment, data_start, dirty - first);
+        }
+    }
+    // 数据落盘之后再同步包含start/end的段头，断电后恢复的end不会指向尚未落盘的数据
+    // （同步期间生产者新提交的少量数据除外，它们由下一次同步覆盖）
+    if (ok)
+    {
+        ok = sync_range(segment, 0, data_start);
+    }
+    if (ok)
+    {
+        p->synced_start = start;
+        p->synced_end = end;
+        p->synced_ms = time_now_ms();
+    }
+    return ok;
+}
+
+/**
+ * @brief 刷盘后解除映射并关闭文件，释放独占锁
+ *
+ * @param p 持久化环形缓冲区结构体指针
+ * @return 最后一次同步成功返回true，否则返回false
+ */
+bool circular_buffer_close_persistent(circular_buffer_persistent *p)
+{
+    bool ok = circular_buffer_sync_persistent(p);
+    shared_segment *segment = segment_of(p->cb);
+    munmap(segment, (size_t)segment->segment_size);
+    close(p->fd);
+    p->cb = NULL;
+    p->fd = -1;
+    return ok;
+}
+#else
+circular_buffer *circular_buffer_create_shared(const char *name, size_t size, const circular_buffer_options *options)
+{
+    // 该平台没有共享内存
+    (void)name;
+    (void)size;
+    (void)options;
+    return NULL;
+}
+
+circular_buffer *circular_buffer_attach_shared(const char *name)
+{
+    (void)name;
+    return NULL;
+}
+
+void circular_buffer_detach_shared(circular_buffer *cb)
+{
+    (void)cb;
+}
+
+bool circular_buffer_unlink_shared(const char *name)
+{
+    (void)name;
+    return false;
+}
+bool circular_buffer_open_persistent(circular_buffer_persistent *p, const char *path, size_t size,
+                                     const circular_buffer_options *options,
+                                     const circular_buffer_persist_policy *policy)
+{
+    // 该平台没有文件映射
+    (void)p;
+    (void)path;
+    (void)size;
+    (void)options;
+    (void)policy;
+    return false;
+}
+
+bool circular_buffer_write_persistent(circular_buffer_persistent *p, const char *data, size_t length)
+{
+    (void)p;
+    (void)data;
+    (void)length;
+    return false;
+}
+
+bool circular_buffer_poll_persistent(circular_buffer_persistent *p)
+{
+    (void)p;
+    return false;
+}
+
+bool circular_buffer_sync_persistent(circular_buffer_persistent *p)
+{
+    (void)p;
+    return false;
+}
+
+bool circular_buffer_close_persistent(circular_buffer_persistent *p)
+{
+    (void)p;
+    return false;
+}
+#endif
@@ -0,0 +1,152 @@
+// circular_buffer_shared.h
+#ifndef CIRCULAR_BUFFER_SHARED_H
+#define CIRCULAR_BUFFER_SHARED_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "circular_buffer.h"
+
+/**
+ * @brief 创建跨进程共享的环形缓冲区
+ *
+ * 以shm_open创建名为name的共享内存段，段内依次存放段头、环形缓冲区结构体和数据区（按页对齐），
+ * 结构体中不保存指针，数据区按结构体自身地址加偏移定位，各进程映射到不同地址时都能正确访问。
+ * 返回的指针可直接用于circular_buffer_write/circular_buffer_read等全部接口。
+ *
+ * 同步方式随编译配置：
+ * - 关闭锁（ENABLE_LOCK为0）时为单生产者单消费者无锁模式，一个进程写、一个进程读，
+ *   等待接口通过跨进程futex唤醒；任一方退出都不会阻塞另一方。
+ * - 启用锁时互斥锁为进程间共享的健壮锁，持有锁的进程崩溃后，另一方下一次加锁时接管锁继续工作；
+ *   索引只在每次操作的最后原子发布，崩溃进程写了一半的数据不会被读取端看到。
+ * 两个进程必须使用相同的编译配置，circular_buffer_attach_shared会校验布局。
+ * 不支持多生产者模式和镜像映射。仅Linux平台支持。
+ *
+ * @param name 共享内存段名称，以'/'开头，如"/capture_ring"；同名的段已存在时失败
+ * @param size 缓冲区大小（必须为2的幂次）
+ * @param options 初始化选项，可以为NULL
+ * @return 成功返回映射中的环形缓冲区指针，失败返回NULL
+ */
+circular_buffer *circular_buffer_create_shared(const char *name, size_t size, const circular_buffer_options *options);
+
+/**
+ * @brief 映射已经由其他进程创建的共享环形缓冲区
+ *
+ * 创建者尚未完成初始化、段不存在或布局不一致（编译配置不同）时失败。
+ *
+ * @param name 共享内存段名称
+ * @return 成功返回映射中的环形缓冲区指针，失败返回NULL
+ */
+circular_buffer *circular_buffer_attach_shared(const char *name);
+
+/**
+ * @brief 解除当前进程对共享环形缓冲区的映射
+ *
+ * 不销毁锁，也不影响其他进程；共享环形缓冲区不能调用circular_buffer_free。
+ *
+ * @param cb circular_buffer_create_shared或circular_buffer_attach_shared返回的指针
+ */
+void circular_buffer_detach_shared(circular_buffer *cb);
+
+/**
+ * @brief 删除共享内存段的名称
+ *
+ * 已经映射的进程不受影响，全部进程解除映射后内存被回收。
+ *
+ * @param name 共享内存段名称
+ * @return 成功返回true，失败返回false
+ */
+bool circular_buffer_unlink_shared(const char *name);
+
+/**
+ * @brief 持久化环形缓冲区的msync批量策略
+ *
+ * 写入只进入页缓存，进程崩溃后数据由内核保留；策略决定多久把脏页刷到磁盘，
+ * 以承受断电或内核崩溃。两项都为0时只在circular_buffer_sync_persistent和关闭时刷盘。
+ */
+typedef struct
+{
+    size_t sync_bytes;             /**< 自上次同步以来写入的字节数达到该值时同步，0表示不按字节数同步 */
+    unsigned int sync_interval_ms; /**< 距上次同步超过该毫秒数且有新数据时同步，0表示不按时间同步 */
+} circular_buffer_persist_policy;
+
+/**
+ * @brief 以文件为存储的持久化环形缓冲区
+ */
+typedef struct
+{
+    circular_buffer *cb;                   /**< 映射中的环形缓冲区，可直接用于全部读写接口 */
+    int fd;                                /**< 持有独占flock的文件描述符 */
+    circular_buffer_persist_policy policy; /**< msync批量策略 */
+    size_t synced_start;                   /**< 上次同步时的start */
+    size_t synced_end;                     /**< 上次同步时的end，其之前的数据已经落盘 */
+    uint64_t synced_ms;                    /**< 上次同步的时间（毫秒） */
+} circular_buffer_persistent;
+
+/**
+ * @brief 打开以文件为存储的持久化环形缓冲区，文件不存在时创建
+ *
+ * 文件布局与共享内存段相同：段头、环形缓冲区结构体（含start/end）和数据区，整体以MAP_SHARED映射，
+ * 写入以内存速度进入页缓存。进程退出或崩溃后再次打开同一文件，start、end和数据原样恢复，
+ * 锁、等待标志和预留状态重新初始化，崩溃时写了一半、尚未提交的数据被丢弃。
+ * 重新打开时沿用文件中的选项和写入策略，options只在创建时使用。
+ *
+ * 打开期间持有文件的独占flock，同一文件同时只能打开一次；文件的大小或布局（编译配置）
+ * 与本次调用不一致时失败，不会改动文件内容。不支持多生产者模式和镜像映射。仅Linux平台支持。
+ *
+ * @param p 持久化环形缓冲区结构体指针
+ * @param path 文件路径
+ * @param size 缓冲区大小（必须为2的幂次），重新打开时必须与创建时相同
+ * @param options 初始化选项，可以为NULL
+ * @param policy msync批量策略，可以为NULL（只在显式同步和关闭时刷盘）
+ * @return 成功返回true，失败返回false
+ */
+bool circular_buffer_open_persistent(circular_buffer_persistent *p, const char *path, size_t size,
+                                     const circular_buffer_options *options,
+                                     const circular_buffer_persist_policy *policy);
+
+/**
+ * @brief 写入数据，并按批量策略决定是否刷盘
+ *
+ * 等同于circular_buffer_write后调用circular_buffer_poll_persistent。
+ * 刷盘失败不影响返回值，已写入的数据留到下一次同步时重试，关闭时返回失败。
+ *
+ * @param p 持久化环形缓冲区结构体指针
+ * @param data 数据指针
+ * @param length 数据长度
+ * @return 写入成功返回true，空间不足返回false
+ */
+bool circular_buffer_write_persistent(circular_buffer_persistent *p, const char *data, size_t length);
+
+/**
+ * @brief 按批量策略检查是否需要刷盘，需要时同步
+ *
+ * 通过其他接口（如预留/提交）写入时在提交后调用。时间策略没有后台线程，
+ * 只在调用本函数时检查；同步状态不加锁，只能由一个线程（通常是生产者）调用。
+ *
+ * @param p 持久化环形缓冲区结构体指针
+ * @return 无需同步或同步成功返回true，msync失败返回false
+ */
+bool circular_buffer_poll_persistent(circular_buffer_persistent *p);
+
+/**
+ * @brief 立即把上次同步以来写入的数据和段头刷到磁盘
+ *
+ * 先同步数据区中新写入的范围，再同步包含start/end的段头。
+ *
+ * @param p 持久化环形缓冲区结构体指针
+ * @return 成功返回true，msync失败返回false
+ */
+bool circular_buffer_sync_persistent(circular_buffer_persistent *p);
+
+/**
+ * @brief 刷盘后解除映射并关闭文件，释放独占锁
+ *
+ * 持久化环形缓冲区不能调用circular_buffer_free。
+ *
+ * @param p 持久化环形缓冲区结构体指针
+ * @return 最后一次同步成功返回true，否则返回false
+ */
+bool circular_buffer_close_persistent(circular_buffer_persistent *p);
+
+#endif // CIRCULAR_BUFFER_SHARED_H
@@ -0,0 +1,384 @@
+// circular_buffer_splice.c
+#define _GNU_SOURCE
+#include "circular_buffer_splice.h"
+#include <errno.h>
+#include <limits.h>
+
+#if defined(PLATFORM_LINUX)
+#include <fcntl.h>
+#include <linux/errqueue.h>
+#include <netinet/in.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+/**
+ * @brief 初始化发送器
+ *
+ * @param s 发送器结构体指针
+ * @param cb 已初始化的环形缓冲区
+ * @param out_fd 目标文件描述符
+ * @return 成功返回true，失败返回false
+ */
+bool circular_buffer_splicer_init(circular_buffer_splicer *s, circular_buffer *cb, int out_fd)
+{
+    if (cb->policy == CIRCULAR_BUFFER_POLICY_OVERWRITE)
+    {
+        return false; // 覆盖旧数据时写入端会越过start，借出的页面可能被改写
+    }
+    struct stat st;
+    if (fstat(out_fd, &st) != 0)
+    {
+        return false;
+    }
+
+    memset(s, 0, sizeof(*s));
+    s->cb = cb;
+    s->out_fd = out_fd;
+    s->pipe_fds[0] = -1;
+    s->pipe_fds[1] = -1;
+    if (S_ISSOCK(st.st_mode))
+    {
+        // 发送队列的长度不能说明页面已经释放（TCP确认后数据可能仍在对端的接收队列中引用页面），
+        // 只有MSG_ZEROCOPY的完成通知是可靠的归还信号；不支持SO_ZEROCOPY的套接字（如Unix域）失败
+        int one = 1;
+        s->zerocopy = true;
+        return setsockopt(out_fd, SOL_SOCKET, SO_ZEROCOPY, &one, sizeof(one)) == 0;
+    }
+    if (!S_ISREG(st.st_mode))
+    {
+        return false; // 管道等目标的读取端可以继续引用页面，无法判断何时归还
+    }
+
+    if (pipe2(s->pipe_fds, O_CLOEXEC | O_NONBLOCK) != 0)
+    {
+        return false;
+    }
+    // 管道的每个槽位引用一个页面，不对齐的两段区域最多比缓冲区多跨越两个页面，
+    // 按此调整容量，使一次vmsplice能够借出全部数据；失败时保留默认的16页
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    int pipe_size = (cb->size > INT_MAX - 2 * page) ? INT_MAX : (int)(cb->size + 2 * page);
+    (void)fcntl(s->pipe_fds[1], F_SETPIPE_SZ, pipe_size);
+    return true;
+}
+
+/**
+ * @brief 释放发送器资源
+ *
+ * @param s 发送器结构体指针
+ */
+void circular_buffer_splicer_free(circular_buffer_splicer *s)
+{
+    if (s->pipe_fds[0] >= 0)
+    {
+        close(s->pipe_fds[0]);
+        close(s->pipe_fds[1]);
+    }
+    s->pipe_fds[0] = -1;
+    s->pipe_fds[1] = -1;
+    s->piped = 0;
+}
+
+/**
+ * @brief 读取套接字错误队列中的MSG_ZEROCOPY完成通知，标记对应的发送
+ *
+ * 一条通知覆盖序号[ee_info, ee_data]的一段连续发送，不在等待范围内的序号忽略。
+ *
+ * @param s 发送器结构体指针
+ */
+static void splicer_collect_completions(circular_buffer_splicer *s)
+{
+    for (;;)
+    {
+        char control[128];
+        struct msghdr msg;
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_control = control;
+        msg.msg_controllen = sizeof(control);
+        if (recvmsg(s->out_fd, &msg, MSG_ERRQUEUE | MSG_DONTWAIT) < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return; // 错误队列为空
+        }
+        for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg); cmsg != NULL; cmsg = CMSG_NXTHDR(&msg, cmsg))
+        {
+            bool recverr = (cmsg->cmsg_level == SOL_IP && cmsg->cmsg_type == IP_RECVERR) ||
+                           (cmsg->cmsg_level == SOL_IPV6 && cmsg->cmsg_type == IPV6_RECVERR);
+            if (!recverr)
+            {
+                continue;
+            }
+            struct sock_extended_err serr;
+            memcpy(&serr, CMSG_DATA(cmsg), sizeof(serr));
+            if (serr.ee_origin != SO_EE_ORIGIN_ZEROCOPY)
+            {
+                continue;
+            }
+            // 序号为32位自由增长的计数，按差值比较可以跨越回绕
+            for (uint32_t id = serr.ee_info; id - serr.ee_info <= serr.ee_data - serr.ee_info; id++)
+            {
+                if (id - s->zc_head < s->zc_next - s->zc_head)
+                {
+                    s->zc_done[id % CIRCULAR_BUFFER_SPLICER_MAX_SENDS] = true;
+                }
+                if (id == serr.ee_data)
+                {
+                    break; // 覆盖全部32位序号时避免死循环
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief 计算借出的数据中内核已经不再引用的字节数，并更新内部记录
+ *
+ * 套接字：从最早的发送开始，连续收到完成通知的发送可以归还，中间有未完成的发送时停止，
+ * 保证归还的总是start之后连续的一段。
+ * 普通文件：splice到文件时数据已经拷贝到页缓存，离开内部管道的数据都可以归还。
+ * 图示:
+ *  start                          start + lent
+ *    |                                 |
+ *    [ 可以归还 ][ 内核仍在引用的数据 ]
+ *
+ * @param s 发送器结构体指针
+ * @return 可以归还的字节数
+ */
+static size_t splicer_released(circular_buffer_splicer *s)
+{
+    if (s->lent == 0)
+    {
+        return 0;
+    }
+    if (!s->zerocopy)
+    {
+        return s->lent - s->piped;
+    }
+    splicer_collect_completions(s);
+    size_t released = 0;
+    while (s->zc_head != s->zc_next && s->zc_done[s->zc_head % CIRCULAR_BUFFER_SPLICER_MAX_SENDS])
+    {
+        released += s->zc_length[s->zc_head % CIRCULAR_BUFFER_SPLICER_MAX_SENDS];
+        s->zc_head++;
+    }
+    return released;
+}
+
+/**
+ * @brief 归还内核已经不再引用的借出数据
+ *
+ * @param s 发送器结构体指针
+ * @return 本次归还的字节数
+ */
+size_t circular_buffer_splicer_reclaim(circular_buffer_splicer *s)
+{
+    circular_buffer_spans spans;
+    if (s->lent == 0 || circular_buffer_peek_spans(s->cb, &spans) == 0)
+    {
+        return 0;
+    }
+    size_t released = splicer_released(s);
+    circular_buffer_consume(s->cb, released); // 推进start，写入端可以复用这部分空间
+    s->lent -= released;
+    return released;
+}
+
+/**
+ * @brief 取得尚未借出的数据区域（最多两段），跳过start之后已经借出的部分
+ *
+ * 调用前必须持有读取端（circular_buffer_peek_spans成功后）。
+ *
+ * @param s 发送器结构体指针
+ * @param spans circular_buffer_peek_spans得到的全部可读区域
+ * @param iov 输出的区域
+ * @return 区域个数
+ */
+static int splicer_unsent(const circular_buffer_splicer *s, const circular_buffer_spans *spans, struct iovec iov[2])
+{
+    int count = 0;
+    size_t skip = s->lent;
+    for (size_t i = 0; i < spans->count; i++)
+    {
+        if (skip >= spans->span[i].length)
+        {
+            skip -= spans->span[i].length;
+            continue;
+        }
+        iov[count].iov_base = spans->span[i].data + skip;
+        iov[count].iov_len = spans->span[i].length - skip;
+        skip = 0;
+        count++;
+    }
+    return count;
+}
+
+/**
+ * @brief 将尚未发送的数据以一次MSG_ZEROCOPY的sendmsg交给套接字，同时归还已经完成的发送
+ *
+ * @param s 发送器结构体指针
+ * @return 发送的字节数，-1表示出错
+ */
+static ssize_t splicer_send_zerocopy(circular_buffer_splicer *s)
+{
+    circular_buffer_spans spans;
+    if (circular_buffer_peek_spans(s->cb, &spans) == 0)
+    {
+        return 0; // 缓冲区为空，此时也没有借出的数据
+    }
+    struct iovec iov[2];
+    int count = splicer_unsent(s, &spans, iov);
+    size_t released = splicer_released(s);
+    ssize_t n = 0;
+    if (count > 0 && s->zc_next - s->zc_head >= CIRCULAR_BUFFER_SPLICER_MAX_SENDS)
+    {
+        errno = EAGAIN; // 记录已满，等待完成通知
+        n = -1;
+    }
+    else if (count > 0)
+    {
+        struct msghdr msg;
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_iov = iov;
+        msg.msg_iovlen = (size_t)count;
+        do
+        {
+            n = sendmsg(s->out_fd, &msg, MSG_ZEROCOPY | MSG_DONTWAIT | MSG_NOSIGNAL);
+        } while (n < 0 && errno == EINTR);
+        if (n < 0 && errno == ENOBUFS)
+        {
+            errno = EAGAIN; // 完成通知占用的内存（optmem）已满，等待通知被读取后重试
+        }
+    }
+
+    int saved_errno = errno;
+    circular_buffer_consume(s->cb, released);
+    s->lent -= released;
+    if (n > 0)
+    {
+        // 每次成功的sendmsg占用一个完成通知序号，即使只发送了一部分
+        s->zc_length[s->zc_next % CIRCULAR_BUFFER_SPLICER_MAX_SENDS] = (size_t)n;
+        s->zc_done[s->zc_next % CIRCULAR_BUFFER_SPLICER_MAX_SENDS] = false;
+        s->zc_next++;
+        s->lent += (size_t)n;
+    }
+    errno = saved_errno;
+    return n;
+}
+
+/**
+ * @brief 将尚未发送的数据以vmsplice挂入内部管道，同时归还已经不再引用的数据
+ *
+ * @param s 发送器结构体指针
+ * @return 挂入内部管道的字节数，-1表示出错
+ */
+static ssize_t splicer_lend(circular_buffer_splicer *s)
+{
+    circular_buffer_spans spans;
+    if (circular_buffer_peek_spans(s->cb, &spans) == 0)
+    {
+        return 0; // 缓冲区为空，此时也没有借出的数据
+    }
+
+    // 剩余（最多两段）区域在一次vmsplice中提交
+    struct iovec iov[2];
+    int count = splicer_unsent(s, &spans, iov);
+    ssize_t n = 0;
+    if (count > 0)
+    {
+        // 不使用SPLICE_F_GIFT：赠予的页面此后永远不能再修改，而归还之后写入端会复用这些页面
+        do
+        {
+            n = vmsplice(s->pipe_fds[1], iov, (unsigned long)count, SPLICE_F_NONBLOCK);
+        } while (n < 0 && errno == EINTR);
+    }
+
+    int saved_errno = errno;
+    size_t released = splicer_released(s);
+    circular_buffer_consume(s->cb, released);
+    s->lent -= released;
+    if (n > 0)
+    {
+        s->lent += (size_t)n;
+        s->piped += (size_t)n;
+    }
+    errno = saved_errno;
+    return n;
+}
+
+/**
+ * @brief 将环形缓冲区中尚未发送的数据交给内核
+ *
+ * @param s 发送器结构体指针
+ * @return 本次交给目标的字节数，-1表示出错
+ */
+ssize_t circular_buffer_splicer_send(circular_buffer_splicer *s)
+{
+    if (s->zerocopy)
+    {
+        return splicer_send_zerocopy(s);
+    }
+
+    // 内部管道已满时返回EAGAIN，管道中原有的数据照常推送
+    if (splicer_lend(s) < 0 && errno != EAGAIN)
+    {
+        return -1;
+    }
+
+    ssize_t sent = 0;
+    while (s->piped > 0)
+    {
+        // 管道中的页面移交给文件，文件系统在splice返回前把数据拷贝到页缓存
+        ssize_t n = splice(s->pipe_fds[0], NULL, s->out_fd, NULL, s->piped, SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+        if (n > 0)
+        {
+            s->piped -= (size_t)n;
+            sent += n;
+        }
+        else if (n < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        else if (n == 0 || sent > 0)
+        {
+            break; // 已经推送了一部分，剩余数据留在内部管道中，下次调用继续
+        }
+        else
+        {
+            return -1; // 目标暂时无法写入（EAGAIN）或出错
+        }
+    }
+    return sent;
+}
+#else
+bool circular_buffer_splicer_init(circular_buffer_splicer *s, circular_buffer *cb, int out_fd)
+{
+    // 该平台没有vmsplice/splice
+    (void)s;
+    (void)cb;
+    (void)out_fd;
+    return false;
+}
+
+void circular_buffer_splicer_free(circular_buffer_splicer *s)
+{
+    (void)s;
+}
+
+ssize_t circular_buffer_splicer_send(circular_buffer_splicer *s)
+{
+    (void)s;
+    errno = ENOTSUP;
+    return -1;
+}
+
+size_t circular_buffer_splicer_reclaim(circular_buffer_splicer *s)
+{
+    (void)s;
+    return 0;
+}
+#endif
@@ -0,0 +1,95 @@
+// circular_buffer_splice.h
+#ifndef CIRCULAR_BUFFER_SPLICE_H
+#define CIRCULAR_BUFFER_SPLICE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+#include "circular_buffer.h"
+
+/**
+ * @brief 环形缓冲区到套接字/普通文件的内核侧发送器（仅Linux平台）
+ *
+ * 发送路径不经过用户态拷贝，内核直接引用环形缓冲区的页面，按目标类型分为两种方式:
+ * - 套接字：以MSG_ZEROCOPY发送，内核在不再引用页面时通过套接字错误队列发出完成通知
+ *   （SO_EE_ORIGIN_ZEROCOPY），只有收到通知的发送才被归还。目标必须支持SO_ZEROCOPY（TCP、UDP），
+ *   Unix域套接字不支持：对端可以把数据splice到自己的管道中继续引用页面，无法得知何时释放。
+ * - 普通文件：以vmsplice把页面挂入内部管道，再splice到文件，数据在splice返回时已经拷贝到页缓存，
+ *   离开内部管道即可归还。
+ * 内核仍在引用的数据称为“借出”的数据：借出期间start不前进，写入端无法复用这些空间。
+ *
+ * 图示:
+ *   start          start + lent            end
+ *     |                 |                   |
+ * [ ][L][L][L][L][L][L][D][D][D][D][ ][ ][ ][ ]
+ *     借出：内核仍在引用   尚未发送的数据
+ *
+ * 发送器是该环形缓冲区唯一的读取端，使用期间不能再调用circular_buffer_read等读取接口；
+ * 借出的数据仍计入circular_buffer_length。覆盖旧数据策略会在写入端回收借出的空间，不支持。
+ * 管道等其他类型的目标不支持：管道的读取端可以把页面继续splice/tee到别处，无法判断何时归还。
+ */
+typedef struct
+{
+    circular_buffer *cb; /**< 被发送的环形缓冲区 */
+    int out_fd;          /**< 目标文件描述符（套接字或普通文件） */
+    bool zerocopy;       /**< 目标为套接字，以MSG_ZEROCOPY发送 */
+    int pipe_fds[2];     /**< 内部管道（目标为普通文件时使用），[0]为读端，[1]为写端，不使用时为-1 */
+    size_t piped;        /**< 已挂入内部管道、尚未splice到目标的字节数 */
+    size_t lent;         /**< 已借给内核、尚未归还的字节数，位于start之后 */
+    uint32_t zc_head;    /**< 最早尚未收到完成通知的发送序号 */
+    uint32_t zc_next;    /**< 下一次MSG_ZEROCOPY发送的序号，与内核的计数一致 */
+    size_t zc_length[CIRCULAR_BUFFER_SPLICER_MAX_SENDS]; /**< 各次发送的字节数，按序号取模存放 */
+    bool zc_done[CIRCULAR_BUFFER_SPLICER_MAX_SENDS];     /**< 各次发送是否已收到完成通知 */
+} circular_buffer_splicer;
+
+/**
+ * @brief 初始化发送器
+ *
+ * 目标为套接字时开启SO_ZEROCOPY；目标为普通文件时创建内部管道，
+ * 容量尽量调整为缓冲区大小（受/proc/sys/fs/pipe-max-size限制），失败时保留默认容量。
+ * 目标文件描述符设置为非阻塞时，发送器的所有调用都不会阻塞。
+ *
+ * @param s 发送器结构体指针
+ * @param cb 已初始化的环形缓冲区，写入策略不能是覆盖旧数据
+ * @param out_fd 目标文件描述符，支持SO_ZEROCOPY的套接字或普通文件
+ * @return 成功返回true，失败返回false（不支持的平台、写入策略或目标类型、创建管道失败）
+ */
+bool circular_buffer_splicer_init(circular_buffer_splicer *s, circular_buffer *cb, int out_fd);
+
+/**
+ * @brief 释放发送器资源
+ *
+ * 关闭内部管道，尚未splice到目标的数据被丢弃；已经交给目标的数据不受影响。
+ * 借出的数据不会被归还，释放后如需继续复用环形缓冲区，应先等待借出的数据全部归还
+ * （circular_buffer_splicer_reclaim后lent为0）。
+ *
+ * @param s 发送器结构体指针
+ */
+void circular_buffer_splicer_free(circular_buffer_splicer *s);
+
+/**
+ * @brief 将环形缓冲区中尚未发送的数据交给内核
+ *
+ * 先归还内核已经不再引用的数据，再发送尚未发送的数据（跨越环绕点的两段区域在一次调用中提交）：
+ * 套接字以一次MSG_ZEROCOPY的sendmsg发送，普通文件以一次vmsplice挂入内部管道后splice到文件。
+ * 页面归还后会被写入端复用，因此不以SPLICE_F_GIFT赠予页面。
+ *
+ * @param s 发送器结构体指针
+ * @return 本次交给目标的字节数，没有待发送数据时返回0；
+ *         -1表示出错，errno为EAGAIN（目标暂时无法写入，或等待完成通知的发送已达
+ *         CIRCULAR_BUFFER_SPLICER_MAX_SENDS次，稍后重试）或sendmsg/splice/vmsplice的其他错误
+ */
+ssize_t circular_buffer_splicer_send(circular_buffer_splicer *s);
+
+/**
+ * @brief 归还内核已经不再引用的借出数据，使写入端可以复用这部分空间
+ *
+ * 套接字按错误队列中的完成通知归还，完成通知可能乱序到达，只归还从start开始连续完成的部分。
+ *
+ * @param s 发送器结构体指针
+ * @return 本次归还的字节数
+ */
+size_t circular_buffer_splicer_reclaim(circular_buffer_splicer *s);
+
+#endif // CIRCULAR_BUFFER_SPLICE_H
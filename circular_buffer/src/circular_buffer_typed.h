@@ -0,0 +1,162 @@
+// circular_buffer_typed.h
+#ifndef CIRCULAR_BUFFER_TYPED_H
+#define CIRCULAR_BUFFER_TYPED_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include "circular_buffer.h"
+
+/**
+ * @def CIRCULAR_BUFFER_DEFINE
+ * @brief 为元素类型T生成定长元素环形缓冲区类型name及其操作函数
+ *
+ * 生成的环形缓冲区以元素为单位：容量是元素个数（必须为2的幂次），读写以结构体赋值整体移动T，
+ * 拷贝循环的元素类型和步长在编译期已知，编译器可以展开和向量化。
+ * 索引、掩码、锁、等待通知和写入策略全部复用circular_buffer：内部的circular_buffer以
+ * “1个单位 = 1个元素”初始化，其size为元素个数，通过circular_buffer_write_reserve_policy/
+ * circular_buffer_peek_spans取得的内存段偏移即元素下标，元素实际存放在slots数组中。
+ * 因此sizeof(T)无需是2的幂次。
+ *
+ * 生成的接口（name为传入的类型名）:
+ * - bool name_init(name *ring, size_t capacity, circular_buffer_policy policy)
+ * - bool name_init_static(name *ring, T *storage, size_t capacity, circular_buffer_policy policy)
+ * - void name_free(name *ring)
+ * - size_t name_push_n(name *ring, const T *values, size_t count)
+ * - bool name_push(name *ring, const T *value)
+ * - size_t name_pop_n(name *ring, T *values, size_t count)
+ * - bool name_pop(name *ring, T *value)
+ * - size_t name_count(name *ring)
+ *
+ * push_n按写入策略处理空间不足：拒绝新数据时全部写入或返回0，截断新数据时写入能容纳的前一部分，
+ * 覆盖旧数据时丢弃最早的元素（最多保留最后capacity个新元素）。
+ * 无锁模式（ENABLE_LOCK为0）下预留不支持覆盖旧数据，以该策略初始化会失败。
+ * 不支持多生产者模式和镜像映射。
+ *
+ * 用法:
+ * typedef struct { uint64_t id; float value[14]; } sample;
+ * CIRCULAR_BUFFER_DEFINE(sample_ring, sample)
+ *
+ * sample_ring ring;
+ * sample_ring_init(&ring, 1024, CIRCULAR_BUFFER_POLICY_REJECT);
+ * sample_ring_push(&ring, &s);
+ *
+ * @param name 生成的环形缓冲区类型名，同时作为函数名前缀
+ * @param T 元素类型
+ */
+#define CIRCULAR_BUFFER_DEFINE(name, T)                                                                          \
+    typedef struct                                                                                                \
+    {                                                                                                             \
+        circular_buffer base; /**< 以元素为单位的环形缓冲区，负责索引、锁和写入策略 */                   \
+        T *slots;             /**< 元素数组，base中的偏移即数组下标 */                                     \
+        bool owns_slots;      /**< slots由name_init分配，name_free时释放 */                                   \
+    } name;                                                                                                       \
+                                                                                                                  \
+    static inline bool name##_init_static(name *ring, T *storage, size_t capacity, circular_buffer_policy policy) \
+    {                                                                                                             \
+        circular_buffer_options options = {.policy = policy};                                                    \
+        if (!ENABLE_LOCK && policy == CIRCULAR_BUFFER_POLICY_OVERWRITE)                                           \
+        {                                                                                                         \
+            return false; /* 无锁模式下预留总是失败，push_n会静默丢弃全部元素 */                          \
+        }                                                                                                         \
+        ring->slots = storage;                                                                                    \
+        ring->owns_slots = false;                                                                                 \
+        return circular_buffer_init_static_ex(&ring->base, storage, capacity, &options);                         \
+    }                                                                                                             \
+                                                                                                                  \
+    static inline bool name##_init(name *ring, size_t capacity, circular_buffer_policy policy)                    \
+    {                                                                                                             \
+        if (capacity == 0 || capacity > SIZE_MAX / sizeof(T))                                                     \
+        {                                                                                                         \
+            return false;                                                                                         \
+        }                                                                                                         \
+        T *storage = (T *)malloc(capacity * sizeof(T));                                                           \
+        if (storage == NULL || !name##_init_static(ring, storage, capacity, policy))                             \
+        {                                                                                                         \
+            free(storage);                                                                                        \
+            return false;                                                                                         \
+        }                                                                                                         \
+        ring->owns_slots = true;                                                                                  \
+        return true;                                                                                              \
+    }                                                                                                             \
+                                                                                                                  \
+    static inline void name##_free(name *ring)                                                                    \
+    {                                                                                                             \
+        circular_buffer_free(&ring->base);                                                                        \
+        if (ring->owns_slots)                                                                                     \
+        {                                                                                                         \
+            free(ring->slots);                                                                                    \
+        }                                                                                                         \
+        ring->slots = NULL;                                                                                       \
+    }                                                                                                             \
+                                                                                                                  \
+    static inline size_t name##_push_n(name *ring, const T *values, size_t count)                                 \
+    {                                                                                                             \
+        circular_buffer_spans spans;                                                                              \
+        size_t reserved = circular_buffer_write_reserve_policy(&ring->base, count, &spans);                      \
+        if (reserved == 0)                                                                                        \
+        {                                                                                                         \
+            return 0;                                                                                             \
+        }                                                                                                         \
+        /* 覆盖旧数据时只保留最后reserved个元素，截断新数据时写入前reserved个元素 */                      \
+        if (ring->base.policy == CIRCULAR_BUFFER_POLICY_OVERWRITE)                                                \
+        {                                                                                                         \
+            values += count - reserved;                                                                           \
+        }                                                                                                         \
+        for (size_t s = 0; s < spans.count; s++)                                                                  \
+        {                                                                                                         \
+            T *dst = ring->slots + (spans.span[s].data - ring->base.buffer);                                      \
+            for (size_t i = 0; i < spans.span[s].length; i++)                                                     \
+            {                                                                                                     \
+                dst[i] = values[i];                                                                               \
+            }                                                                                                     \
+            values += spans.span[s].length;                                                                       \
+        }                                                                                                         \
+        circular_buffer_write_commit(&ring->base, reserved);                                                      \
+        return reserved;                                                                                          \
+    }                                                                                                             \
+                                                                                                                  \
+    static inline bool name##_push(name *ring, const T *value)                                                    \
+    {                                                                                                             \
+        return name##_push_n(ring, value, 1) == 1;                                                                \
+    }                                                                                                             \
+                                                                                                                  \
+    static inline size_t name##_pop_n(name *ring, T *values, size_t count)                                        \
+    {                                                                                                             \
+        circular_buffer_spans spans;                                                                              \
+        if (count == 0 || circular_buffer_peek_spans(&ring->base, &spans) == 0)                                   \
+        {                                                                                                         \
+            return 0;                                                                                             \
+        }                                                                                                         \
+        size_t popped = 0;                                                                                        \
+        for (size_t s = 0; s < spans.count && popped < count; s++)                                                \
+        {                                                                                                         \
+            const T *src = ring->slots + (spans.span[s].data - ring->base.buffer);                                \
+            size_t length = spans.span[s].length;                                                                 \
+            if (length > count - popped)                                                                          \
+            {                                                                                                     \
+                length = count - popped;                                                                          \
+            }                                                                                                     \
+            for (size_t i = 0; i < length; i++)                                                                   \
+            {                                                                                                     \
+                values[popped + i] = src[i];                                                                      \
+            }                                                                                                     \
+            popped += length;                                                                                     \
+        }                                                                                                         \
+        /* 覆盖模式只在启用锁时可用，覆盖写入需要持有读取端的锁，元素不会在读取期间被覆盖 */                      \
+        circular_buffer_consume(&ring->base, popped);                                                             \
+        return popped;                                                                                            \
+    }                                                                                                             \
+                                                                                                                  \
+    static inline bool name##_pop(name *ring, T *value)                                                           \
+    {                                                                                                             \
+        return name##_pop_n(ring, value, 1) == 1;                                                                 \
+    }                                                                                                             \
+                                                                                                                  \
+    static inline size_t name##_count(name *ring)                                                                 \
+    {                                                                                                             \
+        return circular_buffer_length(&ring->base);                                                               \
+    }
+
+#endif // CIRCULAR_BUFFER_TYPED_H
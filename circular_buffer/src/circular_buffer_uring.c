@@ -0,0 +1,600 @@
+// circular_buffer_uring.c
+#define _GNU_SOURCE
+#include "circular_buffer_uring.h"
+#include "circular_buffer_io.h"
+#include "circular_buffer_internal.h"
+#include <errno.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(PLATFORM_LINUX)
+#include <linux/io_uring.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// 每轮提交的队列深度：每个连接最多占用两个SQE
+#define URING_ENTRIES_MAX (4096u)
+
+// user_data编码：连接序号 << 1 | 段序号
+#define URING_USER_DATA(id, part) (((uint64_t)(id) << 1) | (uint64_t)(part))
+
+/**
+ * @brief 创建io_uring实例并映射提交队列、完成队列和SQE数组
+ *
+ * @param e 引擎结构体指针
+ * @param entries 提交队列深度
+ * @return 成功返回true
+ */
+static bool uring_setup(circular_buffer_uring *e, unsigned int entries)
+{
+    struct io_uring_params p;
+    memset(&p, 0, sizeof(p));
+    int fd = (int)syscall(__NR_io_uring_setup, entries, &p);
+    if (fd < 0)
+    {
+        return false; // 内核不支持或被禁用（io_uring_disabled、seccomp）
+    }
+
+    e->sq_ring_size = p.sq_off.array + p.sq_entries * sizeof(unsigned int);
+    e->cq_ring_size = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+    if (p.features & IORING_FEAT_SINGLE_MMAP)
+    {
+        // 提交队列和完成队列共用一次映射
+        if (e->cq_ring_size > e->sq_ring_size)
+        {
+            e->sq_ring_size = e->cq_ring_size;
+        }
+        e->cq_ring_size = e->sq_ring_size;
+    }
+    e->sqes_size = p.sq_entries * sizeof(struct io_uring_sqe);
+
+    e->sq_ring = mmap(NULL, e->sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd,
+                      IORING_OFF_SQ_RING);
+    e->cq_ring = (p.features & IORING_FEAT_SINGLE_MMAP)
+                     ? e->sq_ring
+                     : mmap(NULL, e->cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd,
+                            IORING_OFF_CQ_RING);
+    e->sqes = mmap(NULL, e->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+    if (e->sq_ring == MAP_FAILED || e->cq_ring == MAP_FAILED || e->sqes == MAP_FAILED)
+    {
+        if (e->sq_ring != MAP_FAILED)
+        {
+            munmap(e->sq_ring, e->sq_ring_size);
+        }
+        if (e->cq_ring != MAP_FAILED && e->cq_ring != e->sq_ring)
+        {
+            munmap(e->cq_ring, e->cq_ring_size);
+        }
+        if (e->sqes != MAP_FAILED)
+        {
+            munmap(e->sqes, e->sqes_size);
+        }
+        close(fd);
+        return false;
+    }
+
+    char *sq = (char *)e->sq_ring;
+    char *cq = (char *)e->cq_ring;
+    e->sq_head = (unsigned int *)(sq + p.sq_off.head);
+    e->sq_tail = (unsigned int *)(sq + p.sq_off.tail);
+    e->sq_mask = (unsigned int *)(sq + p.sq_off.ring_mask);
+    e->sq_array = (unsigned int *)(sq + p.sq_off.array);
+    e->sq_entries = p.sq_entries;
+    e->cq_head = (unsigned int *)(cq + p.cq_off.head);
+    e->cq_tail = (unsigned int *)(cq + p.cq_off.tail);
+    e->cq_mask = (unsigned int *)(cq + p.cq_off.ring_mask);
+    e->cqes = cq + p.cq_off.cqes;
+    e->ring_fd = fd;
+    return true;
+}
+
+/**
+ * @brief 解除io_uring实例的映射并关闭
+ *
+ * @param e 引擎结构体指针
+ */
+static void uring_teardown(circular_buffer_uring *e)
+{
+    munmap(e->sqes, e->sqes_size);
+    if (e->cq_ring != e->sq_ring)
+    {
+        munmap(e->cq_ring, e->cq_ring_size);
+    }
+    munmap(e->sq_ring, e->sq_ring_size);
+    close(e->ring_fd);
+    e->ring_fd = -1;
+}
+
+/**
+ * @brief 初始化引擎
+ *
+ * @param e 引擎结构体指针
+ * @param max_conns 最多同时管理的连接数
+ * @param flags 初始化选项标志
+ * @return 成功返回true
+ */
+bool circular_buffer_uring_init(circular_buffer_uring *e, unsigned int max_conns, unsigned int flags)
+{
+    memset(e, 0, sizeof(*e));
+    e->ring_fd = -1;
+    if (max_conns == 0)
+    {
+        return false;
+    }
+    e->conns = (circular_buffer_uring_conn *)calloc(max_conns, sizeof(*e->conns));
+    if (e->conns == NULL)
+    {
+        return false;
+    }
+    e->max_conns = max_conns;
+
+    unsigned int entries = (max_conns > URING_ENTRIES_MAX / 2) ? URING_ENTRIES_MAX : max_conns * 2;
+    if (!(flags & CIRCULAR_BUFFER_URING_FLAG_FALLBACK) && uring_setup(e, entries))
+    {
+        // 预留稀疏的固定缓冲区表，添加连接时再填入对应的槽位；
+        // 内核不支持时各连接使用不需要注册的READV/WRITEV
+        struct io_uring_rsrc_register reg;
+        memset(&reg, 0, sizeof(reg));
+        reg.nr = max_conns;
+        reg.flags = IORING_RSRC_REGISTER_SPARSE;
+        (void)syscall(__NR_io_uring_register, e->ring_fd, IORING_REGISTER_BUFFERS2, &reg, sizeof(reg));
+    }
+    return true;
+}
+
+/**
+ * @brief 释放引擎资源
+ *
+ * @param e 引擎结构体指针
+ */
+void circular_buffer_uring_free(circular_buffer_uring *e)
+{
+    if (e->ring_fd >= 0)
+    {
+        uring_teardown(e); // 关闭实例时注册的缓冲区一并释放
+    }
+    free(e->conns);
+    e->conns = NULL;
+    e->max_conns = 0;
+}
+
+/**
+ * @brief 更新固定缓冲区表中连接对应的槽位
+ *
+ * @param e 引擎结构体指针
+ * @param id 连接序号
+ * @param base 缓冲区起始地址，NULL表示清空槽位
+ * @param length 缓冲区长度
+ * @return 成功返回true
+ */
+static bool uring_update_buffer(circular_buffer_uring *e, int id, void *base, size_t length)
+{
+    struct iovec iov = {.iov_base = base, .iov_len = length};
+    struct io_uring_rsrc_update2 update;
+    memset(&update, 0, sizeof(update));
+    update.offset = (unsigned int)id;
+    update.data = (uint64_t)(uintptr_t)&iov;
+    update.nr = 1;
+    return syscall(__NR_io_uring_register, e->ring_fd, IORING_REGISTER_BUFFERS_UPDATE, &update, sizeof(update)) == 1;
+}
+
+/**
+ * @brief 添加一个连接
+ *
+ * @param e 引擎结构体指针
+ * @param cb 环形缓冲区
+ * @param fd 文件描述符
+ * @param direction 传输方向
+ * @return 连接序号，失败返回-1
+ */
+int circular_buffer_uring_add(circular_buffer_uring *e, circular_buffer *cb, int fd,
+                              circular_buffer_uring_direction direction)
+{
+    if (direction == CIRCULAR_BUFFER_URING_FILL && (cb->flags & CIRCULAR_BUFFER_FLAG_MULTI_PRODUCER))
+    {
+        return -1; // 多生产者模式下无法预留空间
+    }
+    if (direction == CIRCULAR_BUFFER_URING_DRAIN && cb->policy == CIRCULAR_BUFFER_POLICY_OVERWRITE)
+    {
+        return -1; // 覆盖旧数据时写入端会改写正在发送的数据
+    }
+    for (unsigned int i = 0; i < e->max_conns; i++)
+    {
+        circular_buffer_uring_conn *conn = &e->conns[i];
+        if (conn->cb != NULL)
+        {
+            continue;
+        }
+        memset(conn, 0, sizeof(*conn));
+        conn->cb = cb;
+        conn->fd = fd;
+        conn->direction = direction;
+        if (e->ring_fd >= 0)
+        {
+            // 镜像映射的缓冲区中连续区域可以延伸到第二份映射，注册两倍大小
+            size_t length = (cb->flags & CIRCULAR_BUFFER_FLAG_MIRROR) ? 2 * cb->size : cb->size;
+            conn->fixed = uring_update_buffer(e, (int)i, circular_buffer_data_base(cb), length);
+        }
+        return (int)i;
+    }
+    return -1; // 连接表已满
+}
+
+/**
+ * @brief 移除一个连接
+ *
+ * @param e 引擎结构体指针
+ * @param id 连接序号
+ * @return 成功返回true，仍有在途操作返回false
+ */
+bool circular_buffer_uring_remove(circular_buffer_uring *e, int id)
+{
+    circular_buffer_uring_conn *conn = &e->conns[id];
+    if (conn->pending > 0)
+    {
+        return false;
+    }
+    if (conn->fixed)
+    {
+        uring_update_buffer(e, id, NULL, 0); // 释放对缓冲区页面的固定
+    }
+    conn->cb = NULL;
+    return true;
+}
+
+/**
+ * @brief 获取连接本轮可以传输的区域
+ *
+ * FILL连接预留end之后的全部空闲空间，DRAIN连接获取start之后的全部数据，
+ * 取得区域后立即以长度0提交/消费释放锁，区域本身在完成之前只有引擎会访问：
+ * 引擎是唯一的写入端（FILL）或唯一的读取端（DRAIN），空闲空间和数据都只会增加，不会被其他人取走。
+ *
+ * @param conn 连接
+ * @return 区域个数，0表示没有可传输的区域
+ */
+static int conn_prepare(circular_buffer_uring_conn *conn)
+{
+    circular_buffer *cb = conn->cb;
+    circular_buffer_spans spans;
+    if (conn->direction == CIRCULAR_BUFFER_URING_FILL)
+    {
+        size_t space = cb->size - circular_buffer_length(cb);
+        if (space == 0 || !circular_buffer_write_reserve(cb, space, &spans))
+        {
+            return 0;
+        }
+        circular_buffer_write_commit(cb, 0);
+    }
+    else
+    {
+        if (circular_buffer_peek_spans(cb, &spans) == 0)
+        {
+            return 0;
+        }
+        circular_buffer_consume(cb, 0);
+    }
+    for (size_t i = 0; i < spans.count; i++)
+    {
+        conn->iov[i].iov_base = spans.span[i].data;
+        conn->iov[i].iov_len = spans.span[i].length;
+    }
+    return (int)spans.count;
+}
+
+/**
+ * @brief 一轮操作全部完成后，按传输的字节数推进环形缓冲区的索引
+ *
+ * @param conn 连接
+ * @param publish true时由本函数推进索引；false时索引已经由circular_buffer_fill_from_fd/
+ *                circular_buffer_drain_to_fd推进，只更新结果
+ */
+static void conn_finish(circular_buffer_uring_conn *conn, bool publish)
+{
+    circular_buffer *cb = conn->cb;
+    circular_buffer_spans spans;
+    size_t n = conn->transferred;
+    if (n > 0 && !publish)
+    {
+        conn->result = (int)n;
+    }
+    else if (n > 0)
+    {
+        // 数据已经由内核写入（或读出），这里只发布索引并唤醒等待的一端
+        // 空闲空间（或数据）少于已传输的字节数，说明有引擎之外的写入端（读取端）改动了环形缓冲区，
+        // 此时不能发布，连接以错误结束
+        bool published;
+        if (conn->direction == CIRCULAR_BUFFER_URING_FILL)
+        {
+            published = circular_buffer_write_reserve(cb, n, &spans);
+            if (published)
+            {
+                circular_buffer_write_commit(cb, n);
+            }
+        }
+        else
+        {
+            size_t available = circular_buffer_peek_spans(cb, &spans);
+            published = (available >= n);
+            if (available > 0)
+            {
+                circular_buffer_consume(cb, published ? n : 0); // 数据不足时只释放锁
+            }
+        }
+        conn->result = published ? (int)n : -EPROTO;
+        conn->closed = !published;
+    }
+    else if (conn->error != 0)
+    {
+        conn->result = conn->error;
+        // 暂时无法读写时下一轮重新提交，其他错误不再提交
+        conn->closed = (conn->error != -EAGAIN && conn->error != -EINTR);
+    }
+    else
+    {
+        conn->result = 0;
+        conn->closed = true; // 读到EOF（或对端不再接收数据）
+    }
+}
+
+/**
+ * @brief 回退模式：对就绪的连接直接调用readv/writev
+ *
+ * @param e 引擎结构体指针
+ * @return 本次处理的连接数
+ */
+static int fallback_submit(circular_buffer_uring *e)
+{
+    int submitted = 0;
+    for (unsigned int i = 0; i < e->max_conns; i++)
+    {
+        circular_buffer_uring_conn *conn = &e->conns[i];
+        if (conn->cb == NULL || conn->closed)
+        {
+            continue;
+        }
+        bool fill = (conn->direction == CIRCULAR_BUFFER_URING_FILL);
+        if (fill ? circular_buffer_is_full(conn->cb) : circular_buffer_is_empty(conn->cb))
+        {
+            continue;
+        }
+        // 先检查是否就绪，阻塞的文件描述符也不会让本次调用阻塞
+        struct pollfd pfd = {.fd = conn->fd, .events = fill ? POLLIN : POLLOUT};
+        if (poll(&pfd, 1, 0) <= 0)
+        {
+            continue;
+        }
+        ssize_t n = fill ? circular_buffer_fill_from_fd(conn->cb, conn->fd)
+                         : circular_buffer_drain_to_fd(conn->cb, conn->fd);
+        conn->transferred = (n > 0) ? (size_t)n : 0;
+        conn->error = (n < 0) ? -errno : 0;
+        conn_finish(conn, false);
+        e->ready++;
+        submitted++;
+    }
+    return submitted;
+}
+
+/**
+ * @brief 为所有空闲且有工作的连接提交读写
+ *
+ * @param e 引擎结构体指针
+ * @return 本次提交的连接数，-1表示出错
+ */
+int circular_buffer_uring_submit(circular_buffer_uring *e)
+{
+    if (e->ring_fd < 0)
+    {
+        return fallback_submit(e);
+    }
+
+    struct io_uring_sqe *sqes = (struct io_uring_sqe *)e->sqes;
+    unsigned int mask = *e->sq_mask;
+    unsigned int tail = *e->sq_tail;
+    unsigned int head = atomic_load_explicit((_Atomic unsigned int *)e->sq_head, memory_order_acquire);
+    unsigned int first = tail;
+    unsigned int queued = 0;
+    int submitted = 0;
+
+    for (unsigned int i = 0; i < e->max_conns; i++)
+    {
+        circular_buffer_uring_conn *conn = &e->conns[i];
+        if (conn->cb == NULL || conn->closed || conn->pending > 0)
+        {
+            continue;
+        }
+        if (e->sq_entries - (tail - head) < 2)
+        {
+            break; // 提交队列已满，剩余的连接下一轮再提交
+        }
+        int count = conn_prepare(conn);
+        if (count == 0)
+        {
+            continue;
+        }
+
+        // 环绕时两段区域串联提交，前一段读写不完整时后一段以-ECANCELED完成，保证数据顺序
+        // 图示（FILL）:
+        //       end           start
+        //        |              |
+        // [ ][ ][ ][ ][ ][ ][ ][X][X][ ][ ]   ->  SQE0 = [end, 环绕点)  --IO_LINK-->  SQE1 = [0, start)
+        bool fill = (conn->direction == CIRCULAR_BUFFER_URING_FILL);
+        for (int part = 0; part < count; part++)
+        {
+            unsigned int index = tail & mask;
+            struct io_uring_sqe *sqe = &sqes[index];
+            memset(sqe, 0, sizeof(*sqe));
+            sqe->fd = conn->fd;
+            sqe->off = 0; // 流式文件忽略偏移，套接字要求为0
+            if (conn->fixed)
+            {
+                sqe->opcode = fill ? IORING_OP_READ_FIXED : IORING_OP_WRITE_FIXED;
+                sqe->addr = (uint64_t)(uintptr_t)conn->iov[part].iov_base;
+                sqe->len = (unsigned int)conn->iov[part].iov_len;
+                sqe->buf_index = (uint16_t)i;
+            }
+            else
+            {
+                sqe->opcode = fill ? IORING_OP_READV : IORING_OP_WRITEV;
+                sqe->addr = (uint64_t)(uintptr_t)&conn->iov[part];
+                sqe->len = 1;
+            }
+            if (part + 1 < count)
+            {
+                sqe->flags = IOSQE_IO_LINK;
+            }
+            sqe->user_data = URING_USER_DATA(i, part);
+            e->sq_array[index] = index;
+            tail++;
+        }
+        conn->pending = (unsigned int)count;
+        conn->transferred = 0;
+        conn->error = 0;
+        queued += (unsigned int)count;
+        submitted++;
+    }
+
+    if (queued == 0)
+    {
+        return 0;
+    }
+    // release发布SQ尾部，内核读取到新的尾部时SQE已经完整写入
+    atomic_store_explicit((_Atomic unsigned int *)e->sq_tail, tail, memory_order_release);
+    int ret;
+    do
+    {
+        ret = (int)syscall(__NR_io_uring_enter, e->ring_fd, queued, 0, 0, NULL, 0);
+    } while (ret < 0 && errno == EINTR);
+
+    // 只有内核实际取走的SQE会产生完成事件
+    unsigned int consumed = (ret < 0) ? 0 : (unsigned int)ret;
+    e->in_flight += consumed;
+    if (consumed < queued)
+    {
+        // 没有使用SQPOLL，内核只在io_uring_enter中读取提交队列，未被取走的SQE可以撤回，
+        // 对应的连接恢复空闲，下一轮重新准备和提交；连接的第一段已被取走而第二段被撤回时，
+        // 第一段单独完成，按实际传输的字节数推进索引
+        int saved_errno = errno;
+        for (unsigned int t = first + consumed; t != tail; t++)
+        {
+            circular_buffer_uring_conn *conn = &e->conns[sqes[t & mask].user_data >> 1];
+            if (--conn->pending == 0)
+            {
+                submitted--;
+            }
+        }
+        atomic_store_explicit((_Atomic unsigned int *)e->sq_tail, first + consumed, memory_order_release);
+        errno = saved_errno;
+    }
+    return (ret < 0) ? -1 : submitted;
+}
+
+/**
+ * @brief 收割完成事件并推进环形缓冲区的索引
+ *
+ * @param e 引擎结构体指针
+ * @param wait 至少等待的完成事件数
+ * @return 本次完成一轮操作的连接数，-1表示出错
+ */
+int circular_buffer_uring_reap(circular_buffer_uring *e, unsigned int wait)
+{
+    if (e->ring_fd < 0)
+    {
+        int ready = (int)e->ready; // 回退模式在提交时已经完成
+        e->ready = 0;
+        return ready;
+    }
+
+    if (wait > e->in_flight)
+    {
+        wait = e->in_flight; // 不等待不会到来的完成事件
+    }
+    if (wait > 0)
+    {
+        int ret;
+        do
+        {
+            ret = (int)syscall(__NR_io_uring_enter, e->ring_fd, 0, wait, IORING_ENTER_GETEVENTS, NULL, 0);
+        } while (ret < 0 && errno == EINTR);
+        if (ret < 0)
+        {
+            return -1;
+        }
+    }
+
+    struct io_uring_cqe *cqes = (struct io_uring_cqe *)e->cqes;
+    unsigned int mask = *e->cq_mask;
+    unsigned int head = *e->cq_head;
+    // acquire读取CQ尾部，与内核发布完成事件配对，保证CQE和缓冲区中的数据可见
+    unsigned int tail = atomic_load_explicit((_Atomic unsigned int *)e->cq_tail, memory_order_acquire);
+    int finished = 0;
+    for (; head != tail; head++)
+    {
+        struct io_uring_cqe *cqe = &cqes[head & mask];
+        circular_buffer_uring_conn *conn = &e->conns[cqe->user_data >> 1];
+        if (cqe->res > 0)
+        {
+            conn->transferred += (size_t)cqe->res;
+        }
+        else if (cqe->res < 0 && cqe->res != -ECANCELED && conn->error == 0)
+        {
+            conn->error = cqe->res;
+        }
+        e->in_flight--;
+        if (--conn->pending == 0)
+        {
+            conn_finish(conn, true);
+            finished++;
+        }
+    }
+    atomic_store_explicit((_Atomic unsigned int *)e->cq_head, head, memory_order_release);
+    return finished;
+}
+#else
+bool circular_buffer_uring_init(circular_buffer_uring *e, unsigned int max_conns, unsigned int flags)
+{
+    // 该平台没有io_uring和readv/writev
+    (void)e;
+    (void)max_conns;
+    (void)flags;
+    return false;
+}
+
+void circular_buffer_uring_free(circular_buffer_uring *e)
+{
+    (void)e;
+}
+
+int circular_buffer_uring_add(circular_buffer_uring *e, circular_buffer *cb, int fd,
+                              circular_buffer_uring_direction direction)
+{
+    (void)e;
+    (void)cb;
+    (void)fd;
+    (void)direction;
+    return -1;
+}
+
+bool circular_buffer_uring_remove(circular_buffer_uring *e, int id)
+{
+    (void)e;
+    (void)id;
+    return false;
+}
+
+int circular_buffer_uring_submit(circular_buffer_uring *e)
+{
+    (void)e;
+    return -1;
+}
+
+int circular_buffer_uring_reap(circular_buffer_uring *e, unsigned int wait)
+{
+    (void)e;
+    (void)wait;
+    return -1;
+}
+#endif
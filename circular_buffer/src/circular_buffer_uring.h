@@ -0,0 +1,162 @@
+// circular_buffer_uring.h
+#ifndef CIRCULAR_BUFFER_URING_H
+#define CIRCULAR_BUFFER_URING_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <sys/uio.h>
+#include "circular_buffer.h"
+
+/**
+ * @brief 初始化选项标志
+ */
+#define CIRCULAR_BUFFER_URING_FLAG_FALLBACK (1u << 0) /**< 不使用io_uring，始终使用poll + readv/writev */
+
+/**
+ * @brief 连接的传输方向
+ */
+typedef enum
+{
+    CIRCULAR_BUFFER_URING_FILL,  /**< 从文件描述符读取，写入环形缓冲区（引擎是该缓冲区唯一的写入端） */
+    CIRCULAR_BUFFER_URING_DRAIN, /**< 从环形缓冲区读取，写入文件描述符（引擎是该缓冲区唯一的读取端） */
+} circular_buffer_uring_direction;
+
+/**
+ * @brief 引擎中的一个连接：一个环形缓冲区与一个文件描述符之间单方向的传输
+ *
+ * 代理场景下同一个环形缓冲区可以同时作为一个FILL连接和一个DRAIN连接，
+ * 两者在途的区域分别位于end之后的空闲空间和start之后的数据，互不重叠。
+ */
+typedef struct
+{
+    circular_buffer *cb;                       /**< 环形缓冲区，NULL表示该槽位空闲 */
+    int fd;                                    /**< 文件描述符，应为套接字或管道等流式文件 */
+    circular_buffer_uring_direction direction; /**< 传输方向 */
+    bool fixed;                                /**< 缓冲区已注册为固定缓冲区，使用READ_FIXED/WRITE_FIXED */
+    bool closed;                               /**< 已读到EOF或出现不可恢复的错误，不再提交 */
+    unsigned int pending;                      /**< 已提交、尚未收到完成事件的SQE数 */
+    size_t transferred;                        /**< 本轮已完成的字节数 */
+    int error;                                 /**< 本轮出现的第一个错误（-errno），0表示没有 */
+    int result;                                /**< 最近一轮的结果：传输的字节数，0表示EOF，负数为-errno */
+    struct iovec iov[2];                       /**< 本轮提交的（最多两段）连续区域 */
+} circular_buffer_uring_conn;
+
+/**
+ * @brief 批量驱动多个环形缓冲区文件描述符读写的io_uring引擎（仅Linux平台）
+ *
+ * 每个连接的环形缓冲区注册为io_uring固定缓冲区，内核直接访问其存储，省去每次操作的页面固定开销。
+ * circular_buffer_uring_submit为所有空闲连接准备SQE：FILL连接对end之后的空闲区域提交READ_FIXED，
+ * DRAIN连接对start之后的数据提交WRITE_FIXED，环绕时两段区域以IOSQE_IO_LINK串联，前一段不完整时后一段被取消，
+ * 然后以一次io_uring_enter提交全部连接。circular_buffer_uring_reap收割完成事件，按内核返回的字节数
+ * 推进end（circular_buffer_write_commit）或start（circular_buffer_consume），并唤醒等待的读写端。
+ * 在途期间不持有环形缓冲区的锁。
+ *
+ * io_uring不可用（内核不支持、被禁用或指定CIRCULAR_BUFFER_URING_FLAG_FALLBACK）时，
+ * circular_buffer_uring_submit对就绪（poll）的连接直接调用circular_buffer_fill_from_fd/circular_buffer_drain_to_fd，
+ * 接口和结果与io_uring路径相同，不会阻塞。
+ * io_uring路径下文件描述符应为阻塞模式，未就绪的操作在内核中异步等待；非阻塞文件描述符会以-EAGAIN完成，
+ * 下一轮重新提交。
+ *
+ * 用法:
+ * circular_buffer_uring engine;
+ * circular_buffer_uring_init(&engine, 1024, 0);
+ * int in = circular_buffer_uring_add(&engine, &cb, client_fd, CIRCULAR_BUFFER_URING_FILL);
+ * int out = circular_buffer_uring_add(&engine, &cb, upstream_fd, CIRCULAR_BUFFER_URING_DRAIN);
+ * for (;;)
+ * {
+ *     circular_buffer_uring_submit(&engine);
+ *     circular_buffer_uring_reap(&engine, 1);
+ * }
+ */
+typedef struct
+{
+    int ring_fd;          /**< io_uring实例，-1表示使用readv/writev回退 */
+    unsigned int in_flight; /**< 已提交、尚未收割的SQE总数 */
+    unsigned int ready;     /**< 回退模式下本轮已完成、尚未被reap统计的连接数 */
+
+    // 提交队列和完成队列，指向与内核共享的映射
+    unsigned int *sq_head;
+    unsigned int *sq_tail;
+    unsigned int *sq_mask;
+    unsigned int *sq_array;
+    unsigned int sq_entries;
+    void *sqes;
+    unsigned int *cq_head;
+    unsigned int *cq_tail;
+    unsigned int *cq_mask;
+    void *cqes;
+    void *sq_ring;
+    void *cq_ring;
+    size_t sq_ring_size;
+    size_t cq_ring_size;
+    size_t sqes_size;
+
+    circular_buffer_uring_conn *conns; /**< 连接表，下标即固定缓冲区的序号 */
+    unsigned int max_conns;            /**< 连接表容量 */
+} circular_buffer_uring;
+
+/**
+ * @brief 初始化引擎
+ *
+ * @param e 引擎结构体指针
+ * @param max_conns 最多同时管理的连接数
+ * @param flags 初始化选项标志（CIRCULAR_BUFFER_URING_FLAG_*）
+ * @return 成功返回true（包括回退到readv/writev），内存不足或不支持的平台返回false
+ */
+bool circular_buffer_uring_init(circular_buffer_uring *e, unsigned int max_conns, unsigned int flags);
+
+/**
+ * @brief 释放引擎资源
+ *
+ * 关闭io_uring实例时内核会取消尚未完成的操作，之后才能释放或复用连接的环形缓冲区。
+ *
+ * @param e 引擎结构体指针
+ */
+void circular_buffer_uring_free(circular_buffer_uring *e);
+
+/**
+ * @brief 添加一个连接
+ *
+ * FILL连接要求引擎是环形缓冲区唯一的写入端（不支持多生产者模式）；
+ * DRAIN连接要求引擎是唯一的读取端，且写入策略不能是覆盖旧数据（写入端会改写在途的数据）。
+ *
+ * @param e 引擎结构体指针
+ * @param cb 环形缓冲区
+ * @param fd 文件描述符
+ * @param direction 传输方向
+ * @return 连接序号，失败返回-1
+ */
+int circular_buffer_uring_add(circular_buffer_uring *e, circular_buffer *cb, int fd,
+                              circular_buffer_uring_direction direction);
+
+/**
+ * @brief 移除一个连接
+ *
+ * 连接仍有在途的操作时不能移除，可以先shutdown文件描述符使操作完成。
+ *
+ * @param e 引擎结构体指针
+ * @param id 连接序号
+ * @return 成功返回true，仍有在途操作返回false
+ */
+bool circular_buffer_uring_remove(circular_buffer_uring *e, int id);
+
+/**
+ * @brief 为所有空闲且有工作的连接提交读写
+ *
+ * @param e 引擎结构体指针
+ * @return 本次提交的连接数，-1表示io_uring_enter出错
+ */
+int circular_buffer_uring_submit(circular_buffer_uring *e);
+
+/**
+ * @brief 收割完成事件并推进环形缓冲区的索引
+ *
+ * 每个连接的一轮操作全部完成后，其result被更新。
+ *
+ * @param e 引擎结构体指针
+ * @param wait 至少等待的完成事件数，没有在途操作时不等待
+ * @return 本次完成一轮操作的连接数，-1表示io_uring_enter出错
+ */
+int circular_buffer_uring_reap(circular_buffer_uring *e, unsigned int wait);
+
+#endif // CIRCULAR_BUFFER_URING_H
@@ -0,0 +1,140 @@
+// bench_copy.c
+#define _POSIX_C_SOURCE 199309L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "circular_buffer.h"
+
+// 缓冲区大小，需大于最大的块大小
+#define BENCH_BUFFER_SIZE (2u * 1024u * 1024u)
+// 最大的块大小
+#define BENCH_MAX_CHUNK   (1u * 1024u * 1024u)
+// 每个块大小下搬运的总字节数
+#define BENCH_TOTAL_BYTES (256u * 1024u * 1024u)
+
+/**
+ * @brief 获取单调时钟时间（秒）
+ *
+ * @return 当前时间
+ */
+static double now_seconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+/**
+ * @brief 逐字节写入的参考实现（与优化前的circular_buffer_write循环一致）
+ */
+static bool bytewise_write(circular_buffer *cb, const char *data, size_t length)
+{
+    mutex_lock(&cb->mutex);
+    size_t current_length = (atomic_load(&cb->end) - atomic_load(&cb->start)) & (cb->size - 1);
+    if (cb->size - current_length - 1 < length)
+    {
+        mutex_unlock(&cb->mutex);
+        return false;
+    }
+    for (size_t i = 0; i < length; ++i)
+    {
+        size_t end = atomic_load_explicit(&cb->end, memory_order_relaxed);
+        cb->buffer[end] = data[i];
+        atomic_store_explicit(&cb->end, (end + 1) & (cb->size - 1), memory_order_relaxed);
+    }
+    mutex_unlock(&cb->mutex);
+    return true;
+}
+
+/**
+ * @brief 逐字节读取的参考实现（与优化前的circular_buffer_read循环一致）
+ */
+static bool bytewise_read(circular_buffer *cb, char *data, size_t length)
+{
+    mutex_lock(&cb->mutex);
+    size_t current_length = (atomic_load(&cb->end) - atomic_load(&cb->start)) & (cb->size - 1);
+    if (current_length < length)
+    {
+        mutex_unlock(&cb->mutex);
+        return false;
+    }
+    for (size_t i = 0; i < length; ++i)
+    {
+        size_t start = atomic_load_explicit(&cb->start, memory_order_relaxed);
+        data[i] = cb->buffer[start];
+        atomic_store_explicit(&cb->start, (start + 1) & (cb->size - 1), memory_order_relaxed);
+    }
+    mutex_unlock(&cb->mutex);
+    return true;
+}
+
+typedef bool (*write_fn)(circular_buffer *, const char *, size_t);
+typedef bool (*read_fn)(circular_buffer *, char *, size_t);
+
+/**
+ * @brief 测量指定块大小下的读写吞吐量
+ *
+ * @return 吞吐量（MB/s），按写入加读取的字节总数计算
+ */
+static double run_case(write_fn write, read_fn read, size_t chunk, char *src, char *dst)
+{
+    circular_buffer cb;
+    if (!circular_buffer_init(&cb, BENCH_BUFFER_SIZE))
+    {
+        return 0.0;
+    }
+
+    // 小块时限制迭代次数，避免逐字节版本运行过久
+    size_t iterations = BENCH_TOTAL_BYTES / chunk;
+    if (iterations > 4u * 1024u * 1024u)
+    {
+        iterations = 4u * 1024u * 1024u;
+    }
+
+    // 先写入半个块，使后续的读写位置错开，保证环绕路径被覆盖
+    write(&cb, src, chunk / 2 + 1);
+
+    double begin = now_seconds();
+    for (size_t i = 0; i < iterations; ++i)
+    {
+        write(&cb, src, chunk);
+        read(&cb, dst, chunk);
+    }
+    double elapsed = now_seconds() - begin;
+
+    circular_buffer_free(&cb);
+    return (2.0 * (double)chunk * (double)iterations) / elapsed / 1e6;
+}
+
+/**
+ * @brief 主函数：对比逐字节循环与两段批量拷贝在1B到1MiB块大小下的吞吐量
+ *
+ * @return int
+ */
+int main(void)
+{
+    char *src = (char *)malloc(BENCH_MAX_CHUNK);
+    char *dst = (char *)malloc(BENCH_MAX_CHUNK);
+    if (src == NULL || dst == NULL)
+    {
+        printf("分配测试数据失败\n");
+        return 1;
+    }
+    for (size_t i = 0; i < BENCH_MAX_CHUNK; ++i)
+    {
+        src[i] = (char)i;
+    }
+
+    printf("%10s %16s %16s %8s\n", "chunk", "bytewise MB/s", "bulk MB/s", "speedup");
+    for (size_t chunk = 1; chunk <= BENCH_MAX_CHUNK; chunk *= 4)
+    {
+        double bytewise = run_case(bytewise_write, bytewise_read, chunk, src, dst);
+        double bulk = run_case(circular_buffer_write, circular_buffer_read, chunk, src, dst);
+        printf("%10zu %16.1f %16.1f %7.1fx\n", chunk, bytewise, bulk, bulk / bytewise);
+    }
+
+    free(src);
+    free(dst);
+    return 0;
+}
@@ -0,0 +1,171 @@
+// bench_hugepage.c
+#define _GNU_SOURCE
+#include <linux/perf_event.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#include "circular_buffer.h"
+
+// 默认缓冲区大小（MiB），可通过第一个命令行参数覆盖，必须为2的幂次
+#define DEFAULT_BUFFER_MIB (256u)
+// 每次读写的块大小
+#define CHUNK_SIZE         (64u * 1024u)
+// 每种分配方式写满再读空的轮数
+#define PASSES             (4u)
+
+static char chunk[CHUNK_SIZE];
+
+/**
+ * @brief 获取单调时钟时间（秒）
+ *
+ * @return 当前时间
+ */
+static double now_seconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+/**
+ * @brief 打开一个数据TLB未命中计数器
+ *
+ * @param op PERF_COUNT_HW_CACHE_OP_READ或PERF_COUNT_HW_CACHE_OP_WRITE
+ * @return 计数器文件描述符，不支持时返回-1
+ */
+static int open_dtlb_counter(unsigned int op)
+{
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HW_CACHE;
+    attr.config = PERF_COUNT_HW_CACHE_DTLB | (op << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+/**
+ * @brief 读取计数器的值
+ *
+ * @param fd 计数器文件描述符
+ * @return 计数值，计数器不可用时返回-1
+ */
+static long long read_counter(int fd)
+{
+    long long value;
+    if (fd < 0 || read(fd, &value, sizeof(value)) != (ssize_t)sizeof(value))
+    {
+        return -1;
+    }
+    return value;
+}
+
+/**
+ * @brief 以一种分配方式运行一轮测试：反复写满整个缓冲区再读空
+ *
+ * @param name 分配方式名称
+ * @param size 缓冲区大小
+ * @param flags 初始化选项标志
+ */
+static void run(const char *name, size_t size, unsigned int flags)
+{
+    circular_buffer ring;
+    circular_buffer_options options = {.flags = flags};
+    if (!circular_buffer_init_ex(&ring, size, &options))
+    {
+        printf("%-22s init failed\n", name);
+        return;
+    }
+
+    // 预热一轮，让所有页面完成缺页，计时只包含稳定状态下的访问
+    while (circular_buffer_write(&ring, chunk, sizeof(chunk)))
+    {
+    }
+    while (circular_buffer_read(&ring, chunk, sizeof(chunk)))
+    {
+    }
+
+    int load_fd = open_dtlb_counter(PERF_COUNT_HW_CACHE_OP_READ);
+    int store_fd = open_dtlb_counter(PERF_COUNT_HW_CACHE_OP_WRITE);
+    for (int i = 0; i < 2; i++)
+    {
+        int fd = i ? store_fd : load_fd;
+        if (fd >= 0)
+        {
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+
+    double begin = now_seconds();
+    for (unsigned int pass = 0; pass < PASSES; pass++)
+    {
+        while (circular_buffer_write(&ring, chunk, sizeof(chunk)))
+        {
+        }
+        while (circular_buffer_read(&ring, chunk, sizeof(chunk)))
+        {
+        }
+    }
+    double elapsed = now_seconds() - begin;
+
+    long long load_misses = read_counter(load_fd);
+    long long store_misses = read_counter(store_fd);
+    double bytes = 2.0 * (double)size * PASSES; // 每轮写入和读取各size字节
+
+    // 实际生效的分配方式
+    const char *placement = (ring.flags & CIRCULAR_BUFFER_FLAG_HUGE_PAGES)              ? "hugetlb"
+                            : (ring.flags & CIRCULAR_BUFFER_FLAG_TRANSPARENT_HUGE_PAGES) ? "thp"
+                                                                                          : "4k";
+    printf("%-22s %-8s %8.2f GB/s", name, placement, bytes / elapsed / 1e9);
+    if (load_misses >= 0 && store_misses >= 0)
+    {
+        printf("   dTLB load misses %12lld   store misses %12lld\n", load_misses, store_misses);
+    }
+    else
+    {
+        printf("   dTLB counters unavailable\n");
+    }
+
+    if (load_fd >= 0)
+    {
+        close(load_fd);
+    }
+    if (store_fd >= 0)
+    {
+        close(store_fd);
+    }
+    circular_buffer_free(&ring);
+}
+
+/**
+ * @brief 主函数：大容量缓冲区顺序读写的带宽和数据TLB未命中次数
+ *
+ * 分别使用malloc（普通页）、透明大页和显式大页分配缓冲区，反复写满再读空。
+ * 显式大页需要预先预留（如 sysctl vm.nr_hugepages=256），不可用时会回退，
+ * 输出的第二列为实际生效的页面类型。dTLB计数器需要perf_event权限，不可用时只输出带宽。
+ *
+ * @param argc 参数个数
+ * @param argv 第一个参数为缓冲区大小（MiB）
+ * @return int
+ */
+int main(int argc, char **argv)
+{
+    size_t mib = (argc > 1) ? strtoul(argv[1], NULL, 10) : DEFAULT_BUFFER_MIB;
+    size_t size = mib * 1024u * 1024u;
+    memset(chunk, 0x5A, sizeof(chunk));
+
+    printf("%zu MiB ring, %u KiB chunks, %u fill/drain passes\n", mib, CHUNK_SIZE / 1024u, PASSES);
+    printf("%-22s %-8s %13s\n", "request", "actual", "bandwidth");
+    run("malloc", size, 0);
+    run("transparent huge pages", size, CIRCULAR_BUFFER_FLAG_TRANSPARENT_HUGE_PAGES);
+    run("explicit huge pages", size, CIRCULAR_BUFFER_FLAG_HUGE_PAGES);
+    return 0;
+}
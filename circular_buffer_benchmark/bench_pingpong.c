@@ -0,0 +1,150 @@
+// bench_pingpong.c
+#define _GNU_SOURCE
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "circular_buffer.h"
+
+// 乒乓往返次数
+#define PINGPONG_ROUNDS   (1000000u)
+// 流式吞吐测试的总字节数
+#define STREAM_TOTAL      (512u * 1024u * 1024u)
+// 流式吞吐测试的单次读写长度
+#define STREAM_CHUNK      (64u)
+// 测试使用的缓冲区大小
+#define BENCH_BUFFER_SIZE (64u * 1024u)
+
+static circular_buffer ping; // 主线程 -> 对端线程
+static circular_buffer pong; // 对端线程 -> 主线程
+
+/**
+ * @brief 获取单调时钟时间（秒）
+ *
+ * @return 当前时间
+ */
+static double now_seconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+/**
+ * @brief 将当前线程绑定到指定CPU，CPU数量不足时不绑定
+ *
+ * @param cpu CPU编号
+ */
+static void pin_to_cpu(int cpu)
+{
+    if (sysconf(_SC_NPROCESSORS_ONLN) <= cpu)
+    {
+        return;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+}
+
+/**
+ * @brief 写入直到成功，失败时让出CPU，避免单核环境下空转整个时间片
+ */
+static void write_spin(circular_buffer *cb, const char *data, size_t length)
+{
+    while (!circular_buffer_write(cb, data, length))
+    {
+        sched_yield();
+    }
+}
+
+/**
+ * @brief 读取直到成功，失败时让出CPU
+ */
+static void read_spin(circular_buffer *cb, char *data, size_t length)
+{
+    while (!circular_buffer_read(cb, data, length))
+    {
+        sched_yield();
+    }
+}
+
+static void *pingpong_peer(void *arg)
+{
+    (void)arg;
+    char message[8];
+    pin_to_cpu(1);
+    for (unsigned int i = 0; i < PINGPONG_ROUNDS; i++)
+    {
+        read_spin(&ping, message, sizeof(message));
+        write_spin(&pong, message, sizeof(message));
+    }
+    return NULL;
+}
+
+static void *stream_consumer(void *arg)
+{
+    (void)arg;
+    char chunk[STREAM_CHUNK];
+    pin_to_cpu(1);
+    for (size_t received = 0; received < STREAM_TOTAL; received += STREAM_CHUNK)
+    {
+        read_spin(&ping, chunk, sizeof(chunk));
+    }
+    return NULL;
+}
+
+/**
+ * @brief 主函数：跨核乒乓往返延迟与流式吞吐量
+ *
+ * 通过-DCIRCULAR_BUFFER_SEPARATE_INDEX=0/1分别编译为紧凑布局和索引分离布局，
+ * 对比两种布局下的结果。
+ *
+ * @return int
+ */
+int main(void)
+{
+    pthread_t peer;
+    char message[8] = "pingpong";
+    char chunk[STREAM_CHUNK];
+
+    if (!circular_buffer_init(&ping, BENCH_BUFFER_SIZE) || !circular_buffer_init(&pong, BENCH_BUFFER_SIZE))
+    {
+        printf("初始化环形缓冲区失败\n");
+        return 1;
+    }
+    memset(chunk, 0x5A, sizeof(chunk));
+    pin_to_cpu(0);
+
+    printf("layout: %s, sizeof(circular_buffer) = %zu\n", CIRCULAR_BUFFER_SEPARATE_INDEX ? "separate" : "packed",
+           sizeof(circular_buffer));
+
+    // 乒乓往返：每轮一次跨核传递和一次返回
+    pthread_create(&peer, NULL, pingpong_peer, NULL);
+    double begin = now_seconds();
+    for (unsigned int i = 0; i < PINGPONG_ROUNDS; i++)
+    {
+        write_spin(&ping, message, sizeof(message));
+        read_spin(&pong, message, sizeof(message));
+    }
+    double elapsed = now_seconds() - begin;
+    pthread_join(peer, NULL);
+    printf("ping-pong: %.1f ns/round trip\n", elapsed / PINGPONG_ROUNDS * 1e9);
+
+    // 流式吞吐：生产者与消费者同时工作，索引所在缓存行在两核之间频繁传递
+    pthread_create(&peer, NULL, stream_consumer, NULL);
+    begin = now_seconds();
+    for (size_t sent = 0; sent < STREAM_TOTAL; sent += STREAM_CHUNK)
+    {
+        write_spin(&ping, chunk, sizeof(chunk));
+    }
+    pthread_join(peer, NULL);
+    elapsed = now_seconds() - begin;
+    printf("stream (%u B chunks): %.1f MB/s\n", STREAM_CHUNK, STREAM_TOTAL / elapsed / 1e6);
+
+    circular_buffer_free(&ping);
+    circular_buffer_free(&pong);
+    return 0;
+}
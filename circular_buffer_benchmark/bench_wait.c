@@ -0,0 +1,147 @@
+// bench_wait.c
+#define _GNU_SOURCE
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "circular_buffer.h"
+
+// 每种模式发送的消息数量
+#define WAIT_MESSAGES     (20000u)
+// 生产者两条消息之间的间隔（微秒），让消费者有机会进入等待状态
+#define WAIT_INTERVAL_US  (50u)
+// 测试使用的缓冲区大小
+#define BENCH_BUFFER_SIZE (4096u)
+
+static circular_buffer channel;
+static uint64_t latency_ns[WAIT_MESSAGES];
+
+/**
+ * @brief 获取单调时钟时间（纳秒）
+ *
+ * @return 当前时间
+ */
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief 将当前线程绑定到指定CPU，CPU数量不足时不绑定
+ *
+ * @param cpu CPU编号
+ */
+static void pin_to_cpu(int cpu)
+{
+    if (sysconf(_SC_NPROCESSORS_ONLN) <= cpu)
+    {
+        return;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+}
+
+/**
+ * @brief 生产者：按固定间隔写入携带发送时间戳的消息
+ */
+static void *producer(void *arg)
+{
+    (void)arg;
+    struct timespec interval = {0, WAIT_INTERVAL_US * 1000l};
+    pin_to_cpu(1);
+    for (unsigned int i = 0; i < WAIT_MESSAGES; i++)
+    {
+        nanosleep(&interval, NULL);
+        uint64_t stamp = now_ns();
+        circular_buffer_write_timed(&channel, (const char *)&stamp, sizeof(stamp), CIRCULAR_BUFFER_WAIT_FOREVER);
+    }
+    return NULL;
+}
+
+static int compare_u64(const void *a, const void *b)
+{
+    uint64_t x = *(const uint64_t *)a;
+    uint64_t y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief 运行一种等待模式，输出唤醒延迟的分位数
+ *
+ * @param name 模式名称
+ * @param blocking true使用read_timed阻塞等待，false反复轮询circular_buffer_read
+ */
+static void run_mode(const char *name, bool blocking)
+{
+    pthread_t thread;
+    uint64_t stamp;
+
+    pthread_create(&thread, NULL, producer, NULL);
+    for (unsigned int i = 0; i < WAIT_MESSAGES; i++)
+    {
+        if (blocking)
+        {
+            circular_buffer_read_timed(&channel, (char *)&stamp, sizeof(stamp), CIRCULAR_BUFFER_WAIT_FOREVER);
+        }
+        else
+        {
+            while (!circular_buffer_read(&channel, (char *)&stamp, sizeof(stamp)))
+            {
+                // 纯自旋，不让出CPU
+            }
+        }
+        latency_ns[i] = now_ns() - stamp;
+    }
+    pthread_join(thread, NULL);
+
+    qsort(latency_ns, WAIT_MESSAGES, sizeof(latency_ns[0]), compare_u64);
+    printf("%-14s p50 %8.1f us  p90 %8.1f us  p99 %8.1f us  p99.9 %8.1f us  max %8.1f us\n", name,
+           latency_ns[WAIT_MESSAGES * 50 / 100] / 1e3, latency_ns[WAIT_MESSAGES * 90 / 100] / 1e3,
+           latency_ns[WAIT_MESSAGES * 99 / 100] / 1e3, latency_ns[WAIT_MESSAGES * 999 / 1000] / 1e3,
+           latency_ns[WAIT_MESSAGES - 1] / 1e3);
+}
+
+/**
+ * @brief 主函数：消费者唤醒延迟分位数
+ *
+ * 通过-DENABLE_LOCK=0编译时对比纯自旋轮询与自旋+futex休眠两种等待方式，
+ * 通过-DENABLE_LOCK=1编译时测量互斥锁+条件变量的等待方式。
+ * 纯自旋在单核环境下会与生产者争抢CPU，结果只在多核环境下有参考意义。
+ *
+ * @return int
+ */
+int main(void)
+{
+    if (!circular_buffer_init(&channel, BENCH_BUFFER_SIZE))
+    {
+        printf("初始化环形缓冲区失败\n");
+        return 1;
+    }
+    pin_to_cpu(0);
+
+    printf("%u messages, %u us interval\n", WAIT_MESSAGES, WAIT_INTERVAL_US);
+#if ENABLE_LOCK
+    run_mode("mutex-condvar", true);
+#else
+    if (sysconf(_SC_NPROCESSORS_ONLN) > 1)
+    {
+        run_mode("spin-only", false);
+    }
+    else
+    {
+        printf("%-14s skipped (single CPU)\n", "spin-only");
+    }
+    run_mode("futex-hybrid", true);
+#endif
+
+    circular_buffer_free(&channel);
+    return 0;
+}
@@ -1,9 +1,27 @@
+#define _POSIX_C_SOURCE 200809L
 #include "unity.h"
 #include "circular_buffer.h"
+#include "circular_buffer_mpmc.h"
+#include "circular_buffer_typed.h"
+#include "circular_buffer_io.h"
+#include "circular_buffer_splice.h"
+#include "circular_buffer_uring.h"
+#include "circular_buffer_shared.h"
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
 #include <stdio.h>
 #include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
 
 // 定义宏以启用或禁用日志
 // #define ENABLE_LOGGING
@@ -91,18 +109,21 @@ void test_circular_buffer_full(void)
     // 初始化缓冲区
     TEST_ASSERT_TRUE(circular_buffer_init(&cb, buffer_size));
 
-    // 写入数据直到缓冲区满
-    for (size_t i = 0; i < buffer_size - 1; i++)
+    // 写入数据直到缓冲区满，全部size个字节均可用
+    for (size_t i = 0; i < buffer_size; i++)
     {
         write_data[i] = i;
     }
-    TEST_ASSERT_TRUE(circular_buffer_write(&cb, write_data, buffer_size - 1));
+    TEST_ASSERT_TRUE(circular_buffer_write(&cb, write_data, buffer_size));
+    TEST_ASSERT_TRUE(circular_buffer_is_full(&cb));
+    TEST_ASSERT_EQUAL_size_t(buffer_size, circular_buffer_length(&cb));
     // 尝试写入超出缓冲区大小的数据
     TEST_ASSERT_FALSE(circular_buffer_write(&cb, write_data, 1));
 
     // 读取数据
-    TEST_ASSERT_TRUE(circular_buffer_read(&cb, read_data, buffer_size - 1));
-    TEST_ASSERT_EQUAL_UINT8_ARRAY(write_data, read_data, buffer_size - 1);
+    TEST_ASSERT_TRUE(circular_buffer_read(&cb, read_data, buffer_size));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(write_data, read_data, buffer_size);
+    TEST_ASSERT_TRUE(circular_buffer_is_empty(&cb));
 
     // 释放缓冲区
     circular_buffer_free(&cb);
@@ -149,13 +170,18 @@ void test_circular_buffer_boundary(void)
     LOG("读取数据（缓冲区字节数减一）: ");
     PRINT_BUFFER(read_data, buffer_size - 1);
 
+    // 跨越环绕点写满整个缓冲区
+    write_data[buffer_size - 1] = buffer_size - 1;
     LOG("写入数据（等于缓冲区字节数）: ");
     PRINT_BUFFER(write_data, buffer_size);
-    TEST_ASSERT_FALSE(circular_buffer_write(&cb, write_data, buffer_size));
+    TEST_ASSERT_TRUE(circular_buffer_write(&cb, write_data, buffer_size));
+    TEST_ASSERT_FALSE(circular_buffer_write(&cb, write_data, 1));
 
-    TEST_ASSERT_FALSE(circular_buffer_read(&cb, read_data, buffer_size - 1));
-    LOG("读取数据（缓冲区字节数减一）: ");
-    PRINT_BUFFER(read_data, buffer_size - 1);
+    TEST_ASSERT_TRUE(circular_buffer_read(&cb, read_data, buffer_size));
+    LOG("读取数据（等于缓冲区字节数）: ");
+    PRINT_BUFFER(read_data, buffer_size);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(write_data, read_data, buffer_size);
+    TEST_ASSERT_FALSE(circular_buffer_read(&cb, read_data, 1));
 
     // 释放缓冲区
     circular_buffer_free(&cb);
@@ -298,6 +324,1332 @@ void test_circular_buffer_concurrent(void)
     circular_buffer_free(&cb);
 }
 
+// 测试部分读写接口
+void test_circular_buffer_write_read_some(void)
+{
+    circular_buffer cb;
+    size_t buffer_size = 16;
+    char write_data[2 * buffer_size];
+    char read_data[2 * buffer_size];
+
+    TEST_ASSERT_TRUE(circular_buffer_init(&cb, buffer_size));
+
+    for (size_t i = 0; i < sizeof(write_data); i++)
+    {
+        write_data[i] = (char)i;
+    }
+
+    // 空缓冲区读取0字节
+    TEST_ASSERT_EQUAL_size_t(0, circular_buffer_read_some(&cb, read_data, 4));
+
+    // 写入超过容量的数据，只写入剩余空间能容纳的部分
+    TEST_ASSERT_EQUAL_size_t(10, circular_buffer_write_some(&cb, write_data, 10));
+    TEST_ASSERT_EQUAL_size_t(6, circular_buffer_write_some(&cb, write_data + 10, 20));
+    TEST_ASSERT_EQUAL_size_t(0, circular_buffer_write_some(&cb, write_data, 1));
+
+    // 读取超过有效数据长度的请求，只读取已有的部分
+    TEST_ASSERT_EQUAL_size_t(5, circular_buffer_read_some(&cb, read_data, 5));
+    TEST_ASSERT_EQUAL_size_t(5, circular_buffer_write_some(&cb, write_data + 16, 8));
+    TEST_ASSERT_EQUAL_size_t(16, circular_buffer_read_some(&cb, read_data + 5, sizeof(read_data)));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(write_data, read_data, 21);
+    TEST_ASSERT_TRUE(circular_buffer_is_empty(&cb));
+
+    circular_buffer_free(&cb);
+}
+
+// 延迟写入线程：等待一段时间后写入数据，用于测试阻塞读取
+void *delayed_writer_thread(void *arg)
+{
+    circular_buffer *cb = (circular_buffer *)arg;
+    struct timespec delay = {0, 50 * 1000 * 1000};
+    nanosleep(&delay, NULL);
+    circular_buffer_write(cb, "abcdefgh", 8);
+    return NULL;
+}
+
+// 延迟读取线程：等待一段时间后读走数据，用于测试阻塞写入
+void *delayed_reader_thread(void *arg)
+{
+    circular_buffer *cb = (circular_buffer *)arg;
+    char read_data[8];
+    struct timespec delay = {0, 50 * 1000 * 1000};
+    nanosleep(&delay, NULL);
+    circular_buffer_read(cb, read_data, sizeof(read_data));
+    return NULL;
+}
+
+// 测试带超时的阻塞读写接口
+void test_circular_buffer_timed(void)
+{
+    circular_buffer cb;
+    size_t buffer_size = 16;
+    char write_data[buffer_size];
+    char read_data[buffer_size];
+    pthread_t thread;
+
+    TEST_ASSERT_TRUE(circular_buffer_init(&cb, buffer_size));
+
+    // 空缓冲区读取在超时后失败
+    TEST_ASSERT_FALSE(circular_buffer_read_timed(&cb, read_data, 1, 0));
+    TEST_ASSERT_FALSE(circular_buffer_read_timed(&cb, read_data, 1, 20));
+    // 超过缓冲区大小的请求直接失败
+    TEST_ASSERT_FALSE(circular_buffer_read_timed(&cb, read_data, buffer_size + 1, CIRCULAR_BUFFER_WAIT_FOREVER));
+
+    // 读取端等待，写入端写入后被唤醒
+    pthread_create(&thread, NULL, delayed_writer_thread, &cb);
+    TEST_ASSERT_TRUE(circular_buffer_read_timed(&cb, read_data, 8, CIRCULAR_BUFFER_WAIT_FOREVER));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY("abcdefgh", read_data, 8);
+    pthread_join(thread, NULL);
+
+    // 写满后写入在超时后失败
+    memset(write_data, 0x55, sizeof(write_data));
+    TEST_ASSERT_TRUE(circular_buffer_write_timed(&cb, write_data, buffer_size, 0));
+    TEST_ASSERT_FALSE(circular_buffer_write_timed(&cb, write_data, 1, 20));
+
+    // 写入端等待，读取端读走数据后被唤醒
+    pthread_create(&thread, NULL, delayed_reader_thread, &cb);
+    TEST_ASSERT_TRUE(circular_buffer_write_timed(&cb, write_data, 8, 5000));
+    pthread_join(thread, NULL);
+    TEST_ASSERT_TRUE(circular_buffer_is_full(&cb));
+
+    circular_buffer_free(&cb);
+}
+
+// 写入策略测试：同一程序中的三个实例分别使用拒绝、覆盖、截断策略
+void test_circular_buffer_policy(void)
+{
+    circular_buffer reject, overwrite, truncate;
+    circular_buffer_options options = {0};
+    char read_data[8];
+
+    TEST_ASSERT_TRUE(circular_buffer_init(&reject, 8)); // 默认为拒绝新数据策略
+    options.policy = CIRCULAR_BUFFER_POLICY_OVERWRITE;
+    TEST_ASSERT_TRUE(circular_buffer_init_ex(&overwrite, 8, &options));
+    options.policy = CIRCULAR_BUFFER_POLICY_TRUNCATE;
+    TEST_ASSERT_TRUE(circular_buffer_init_ex(&truncate, 8, &options));
+
+    // 无效策略以及多生产者与覆盖策略的组合会被拒绝
+    circular_buffer invalid;
+    options.policy = CIRCULAR_BUFFER_POLICY_COUNT;
+    TEST_ASSERT_FALSE(circular_buffer_init_ex(&invalid, 8, &options));
+    options.flags = CIRCULAR_BUFFER_FLAG_MULTI_PRODUCER;
+    options.policy = CIRCULAR_BUFFER_POLICY_OVERWRITE;
+    TEST_ASSERT_FALSE(circular_buffer_init_ex(&invalid, 8, &options));
+
+    // 先写入6个字节，剩余2个字节的空间，再写入4个字节
+    TEST_ASSERT_TRUE(circular_buffer_write(&reject, "abcdef", 6));
+    TEST_ASSERT_TRUE(circular_buffer_write(&overwrite, "abcdef", 6));
+    TEST_ASSERT_TRUE(circular_buffer_write(&truncate, "abcdef", 6));
+
+    // 拒绝：不写入任何数据
+    TEST_ASSERT_FALSE(circular_buffer_write(&reject, "ghij", 4));
+    TEST_ASSERT_EQUAL_size_t(6, circular_buffer_length(&reject));
+    TEST_ASSERT_TRUE(circular_buffer_read(&reject, read_data, 6));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY("abcdef", read_data, 6);
+
+    // 覆盖：丢弃最早的2个字节
+    TEST_ASSERT_TRUE(circular_buffer_write(&overwrite, "ghij", 4));
+    TEST_ASSERT_TRUE(circular_buffer_is_full(&overwrite));
+    TEST_ASSERT_TRUE(circular_buffer_read(&overwrite, read_data, 8));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY("cdefghij", read_data, 8);
+    // 超过容量的数据只保留最后size个字节
+    TEST_ASSERT_TRUE(circular_buffer_write(&overwrite, "0123456789", 10));
+    TEST_ASSERT_TRUE(circular_buffer_read(&overwrite, read_data, 8));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY("23456789", read_data, 8);
+    // 覆盖策略下等待接口不会等待
+    TEST_ASSERT_TRUE(circular_buffer_write(&overwrite, "abcdefgh", 8));
+    TEST_ASSERT_TRUE(circular_buffer_write_timed(&overwrite, "ij", 2, 0));
+    TEST_ASSERT_EQUAL_size_t(8, circular_buffer_length(&overwrite));
+
+    // 截断：只写入能容纳的前2个字节，已满时返回false
+    TEST_ASSERT_TRUE(circular_buffer_write(&truncate, "ghij", 4));
+    TEST_ASSERT_TRUE(circular_buffer_is_full(&truncate));
+    TEST_ASSERT_FALSE(circular_buffer_write(&truncate, "k", 1));
+    // 截断策略下等待接口仍然要求全部数据都能写入
+    TEST_ASSERT_FALSE(circular_buffer_write_timed(&truncate, "k", 1, 0));
+    TEST_ASSERT_TRUE(circular_buffer_read(&truncate, read_data, 8));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY("abcdefgh", read_data, 8);
+
+    circular_buffer_free(&reject);
+    circular_buffer_free(&overwrite);
+    circular_buffer_free(&truncate);
+}
+
+// 覆盖旧数据策略并发测试：写入端从不等待，读取端被套圈后跳到最早的有效数据，
+// 读到的每条记录都必须完整（序号与校验值一致），且序号严格递增
+#define OVERWRITE_RECORDS 200000
+
+static atomic_bool overwrite_done;
+
+void *overwrite_writer_thread(void *arg)
+{
+    circular_buffer *cb = (circular_buffer *)arg;
+    for (uint32_t seq = 1; seq <= OVERWRITE_RECORDS; seq++)
+    {
+        uint32_t record[2] = {seq, ~seq};
+        circular_buffer_write(cb, (const char *)record, sizeof(record)); // 覆盖策略下写入总是成功
+        if ((seq & 0xFF) == 0)
+        {
+            sched_yield(); // 单核环境下给读取端运行的机会
+        }
+    }
+    atomic_store(&overwrite_done, true);
+    return NULL;
+}
+
+void test_circular_buffer_overwrite_concurrent(void)
+{
+    circular_buffer cb;
+    circular_buffer_options options = {.policy = CIRCULAR_BUFFER_POLICY_OVERWRITE};
+    uint32_t record[2];
+    uint32_t last = 0;
+    size_t received = 0;
+    size_t errors = 0;
+
+    // 记录长度为8字节，缓冲区大小为8的整数倍，重新同步后的位置总是落在记录边界上
+    TEST_ASSERT_TRUE(circular_buffer_init_ex(&cb, 64, &options));
+    atomic_store(&overwrite_done, false);
+
+    pthread_t writer;
+    pthread_create(&writer, NULL, overwrite_writer_thread, &cb);
+    for (;;)
+    {
+        bool done = atomic_load(&overwrite_done);
+        if (!circular_buffer_read(&cb, (char *)record, sizeof(record)))
+        {
+            if (done)
+            {
+                break; // 写入端已结束且数据已读完
+            }
+            sched_yield();
+            continue;
+        }
+        if (record[1] != ~record[0] || record[0] <= last)
+        {
+            errors++;
+        }
+        last = record[0];
+        received++;
+    }
+    pthread_join(writer, NULL);
+
+    TEST_ASSERT_EQUAL_size_t(0, errors);
+    TEST_ASSERT_TRUE(received > 0);
+    TEST_ASSERT_EQUAL_UINT32(OVERWRITE_RECORDS, last); // 最后一条记录一定能读到
+    circular_buffer_free(&cb);
+}
+
+// 测试零拷贝预留/提交写入接口
+void test_circular_buffer_write_reserve_commit(void)
+{
+    circular_buffer cb;
+    size_t buffer_size = 16;
+    char write_data[buffer_size];
+    char read_data[buffer_size];
+    circular_buffer_spans spans;
+
+    TEST_ASSERT_TRUE(circular_buffer_init(&cb, buffer_size));
+
+    // 先移动读写位置，使下一次预留跨越环绕点
+    TEST_ASSERT_TRUE(circular_buffer_write(&cb, write_data, 12));
+    TEST_ASSERT_TRUE(circular_buffer_read(&cb, read_data, 12));
+
+    // 剩余空间不足时预留失败
+    TEST_ASSERT_FALSE(circular_buffer_write_reserve(&cb, buffer_size + 1, &spans));
+    TEST_ASSERT_FALSE(circular_buffer_write_reserve(&cb, 0, &spans));
+
+    // 预留10字节，应拆分为环绕点前4字节和环绕点后6字节
+    TEST_ASSERT_TRUE(circular_buffer_write_reserve(&cb, 10, &spans));
+    TEST_ASSERT_EQUAL_size_t(2, spans.count);
+    TEST_ASSERT_EQUAL_size_t(4, spans.span[0].length);
+    TEST_ASSERT_EQUAL_size_t(6, spans.span[1].length);
+    for (size_t i = 0; i < 10; i++)
+    {
+        write_data[i] = (char)('a' + i);
+    }
+    memcpy(spans.span[0].data, write_data, spans.span[0].length);
+    memcpy(spans.span[1].data, write_data + spans.span[0].length, spans.span[1].length);
+    // 只提交前7字节
+    TEST_ASSERT_TRUE(circular_buffer_write_commit(&cb, 7));
+    TEST_ASSERT_EQUAL_size_t(7, circular_buffer_length(&cb));
+
+    TEST_ASSERT_TRUE(circular_buffer_read(&cb, read_data, 7));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(write_data, read_data, 7);
+
+    // 提交长度超过预留长度时失败，且不发布任何数据
+    TEST_ASSERT_TRUE(circular_buffer_write_reserve(&cb, 4, &spans));
+    TEST_ASSERT_FALSE(circular_buffer_write_commit(&cb, 5));
+    TEST_ASSERT_TRUE(circular_buffer_is_empty(&cb));
+
+    circular_buffer_free(&cb);
+}
+
+// 测试零拷贝查看/消费读取接口
+void test_circular_buffer_peek_consume(void)
+{
+    circular_buffer cb;
+    size_t buffer_size = 16;
+    char write_data[buffer_size];
+    char read_data[buffer_size];
+    circular_buffer_spans spans;
+
+    TEST_ASSERT_TRUE(circular_buffer_init(&cb, buffer_size));
+
+    // 空缓冲区查看长度为0，且不持有锁
+    TEST_ASSERT_EQUAL_size_t(0, circular_buffer_peek_spans(&cb, &spans));
+    TEST_ASSERT_EQUAL_size_t(0, spans.count);
+
+    // 使数据跨越环绕点
+    TEST_ASSERT_TRUE(circular_buffer_write(&cb, write_data, 10));
+    TEST_ASSERT_TRUE(circular_buffer_read(&cb, read_data, 10));
+    for (size_t i = 0; i < 12; i++)
+    {
+        write_data[i] = (char)('A' + i);
+    }
+    TEST_ASSERT_TRUE(circular_buffer_write(&cb, write_data, 12));
+
+    // 可读数据拆分为环绕点前6字节和环绕点后6字节
+    TEST_ASSERT_EQUAL_size_t(12, circular_buffer_peek_spans(&cb, &spans));
+    TEST_ASSERT_EQUAL_size_t(2, spans.count);
+    TEST_ASSERT_EQUAL_size_t(6, spans.span[0].length);
+    TEST_ASSERT_EQUAL_size_t(6, spans.span[1].length);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(write_data, spans.span[0].data, 6);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(write_data + 6, spans.span[1].data, 6);
+    // 只消费前8字节
+    TEST_ASSERT_TRUE(circular_buffer_consume(&cb, 8));
+    TEST_ASSERT_EQUAL_size_t(4, circular_buffer_length(&cb));
+
+    // 消费长度超过可读长度时失败，且不消费任何数据
+    TEST_ASSERT_EQUAL_size_t(4, circular_buffer_peek_spans(&cb, &spans));
+    TEST_ASSERT_EQUAL_size_t(1, spans.count);
+    TEST_ASSERT_FALSE(circular_buffer_consume(&cb, 5));
+    TEST_ASSERT_TRUE(circular_buffer_read(&cb, read_data, 4));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(write_data + 8, read_data, 4);
+
+    circular_buffer_free(&cb);
+}
+
+// 测试消息模式：整条消息读写、零拷贝读取以及环绕点处的填充
+void test_circular_buffer_msg(void)
+{
+    circular_buffer cb;
+    circular_buffer_options options = {.flags = CIRCULAR_BUFFER_FLAG_CONTIGUOUS_MSG};
+    circular_buffer_spans spans;
+    char write_data[64];
+    char read_data[64];
+    size_t length;
+
+    for (size_t i = 0; i < sizeof(write_data); i++)
+    {
+        write_data[i] = (char)(i + 1);
+    }
+
+    TEST_ASSERT_TRUE(circular_buffer_init(&cb, 64));
+
+    // 空缓冲区
+    TEST_ASSERT_FALSE(circular_buffer_pop_msg(&cb, read_data, sizeof(read_data), &length));
+    TEST_ASSERT_EQUAL_size_t(0, length);
+    TEST_ASSERT_FALSE(circular_buffer_peek_msg(&cb, &spans));
+
+    // 消息边界保持不变，包括长度为0的消息
+    TEST_ASSERT_TRUE(circular_buffer_push_msg(&cb, write_data, 3));
+    TEST_ASSERT_TRUE(circular_buffer_push_msg(&cb, write_data, 0));
+    TEST_ASSERT_TRUE(circular_buffer_push_msg(&cb, write_data, 17));
+    TEST_ASSERT_EQUAL_size_t(4 + 4 + 4 + 24, circular_buffer_length(&cb)); // 每条记录按4字节对齐
+    TEST_ASSERT_TRUE(circular_buffer_pop_msg(&cb, read_data, sizeof(read_data), &length));
+    TEST_ASSERT_EQUAL_size_t(3, length);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(write_data, read_data, 3);
+    TEST_ASSERT_TRUE(circular_buffer_pop_msg(&cb, read_data, sizeof(read_data), &length));
+    TEST_ASSERT_EQUAL_size_t(0, length);
+
+    // 目标缓冲区不足时消息保留，length返回所需长度
+    TEST_ASSERT_FALSE(circular_buffer_pop_msg(&cb, read_data, 16, &length));
+    TEST_ASSERT_EQUAL_size_t(17, length);
+    TEST_ASSERT_TRUE(circular_buffer_pop_msg(&cb, read_data, sizeof(read_data), &length));
+    TEST_ASSERT_EQUAL_size_t(17, length);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(write_data, read_data, 17);
+
+    // 空间不足和消息过长时拒绝
+    TEST_ASSERT_FALSE(circular_buffer_push_msg(&cb, write_data, 61));
+    TEST_ASSERT_TRUE(circular_buffer_push_msg(&cb, write_data, 40));
+    TEST_ASSERT_FALSE(circular_buffer_push_msg(&cb, write_data, 17));
+
+    // 不保持连续时，跨越环绕点的负载分为两段：start = 36，负载从40开始，24字节之后环绕
+    TEST_ASSERT_TRUE(circular_buffer_peek_msg(&cb, &spans));
+    TEST_ASSERT_EQUAL_size_t(2, spans.count);
+    TEST_ASSERT_EQUAL_size_t(24, spans.span[0].length);
+    TEST_ASSERT_EQUAL_size_t(16, spans.span[1].length);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(write_data, spans.span[0].data, 24);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(write_data + 24, spans.span[1].data, 16);
+    circular_buffer_consume_msg(&cb);
+    TEST_ASSERT_TRUE(circular_buffer_is_empty(&cb));
+    circular_buffer_free(&cb);
+
+    // 保持连续：单条消息上限降为size / 2 - 4
+    TEST_ASSERT_TRUE(circular_buffer_init_ex(&cb, 64, &options));
+    TEST_ASSERT_FALSE(circular_buffer_push_msg(&cb, write_data, 29));
+    for (int round = 0; round < 20; round++) // 多轮写入读取，记录结束位置不断变化
+    {
+        size_t message = (size_t)(round * 7) % 29;
+        TEST_ASSERT_TRUE(circular_buffer_push_msg(&cb, write_data, message));
+        TEST_ASSERT_TRUE(circular_buffer_push_msg(&cb, write_data + 1, 28 - message));
+        TEST_ASSERT_TRUE(circular_buffer_peek_msg(&cb, &spans));
+        TEST_ASSERT_TRUE(spans.count <= 1);
+        TEST_ASSERT_EQUAL_size_t(message, spans.count ? spans.span[0].length : 0);
+        if (message > 0) // 长度为0的消息没有负载可比较
+        {
+            TEST_ASSERT_EQUAL_UINT8_ARRAY(write_data, spans.span[0].data, message);
+        }
+        circular_buffer_consume_msg(&cb);
+        TEST_ASSERT_TRUE(circular_buffer_peek_msg(&cb, &spans));
+        TEST_ASSERT_TRUE(spans.count <= 1);
+        TEST_ASSERT_EQUAL_size_t(28 - message, spans.count ? spans.span[0].length : 0);
+        if (message < 28)
+        {
+            TEST_ASSERT_EQUAL_UINT8_ARRAY(write_data + 1, spans.span[0].data, 28 - message);
+        }
+        circular_buffer_consume_msg(&cb);
+    }
+    TEST_ASSERT_TRUE(circular_buffer_is_empty(&cb));
+    circular_buffer_free(&cb);
+
+    // 多生产者模式下同样可用，但不能保持连续
+    options.flags = CIRCULAR_BUFFER_FLAG_MULTI_PRODUCER | CIRCULAR_BUFFER_FLAG_CONTIGUOUS_MSG;
+    TEST_ASSERT_FALSE(circular_buffer_init_ex(&cb, 64, &options));
+    options.flags = CIRCULAR_BUFFER_FLAG_MULTI_PRODUCER;
+    TEST_ASSERT_TRUE(circular_buffer_init_ex(&cb, 64, &options));
+    TEST_ASSERT_TRUE(circular_buffer_push_msg(&cb, write_data, 5));
+    TEST_ASSERT_TRUE(circular_buffer_push_msg(&cb, write_data, 6));
+    TEST_ASSERT_TRUE(circular_buffer_pop_msg(&cb, read_data, sizeof(read_data), &length));
+    TEST_ASSERT_EQUAL_size_t(5, length);
+    TEST_ASSERT_TRUE(circular_buffer_pop_msg(&cb, read_data, sizeof(read_data), &length));
+    TEST_ASSERT_EQUAL_size_t(6, length);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(write_data, read_data, 6);
+    circular_buffer_free(&cb);
+}
+
+// 测试按元素类型生成的定长元素环形缓冲区，元素大小不是2的幂次
+typedef struct
+{
+    uint64_t id;
+    uint32_t value[4];
+} typed_element;
+
+CIRCULAR_BUFFER_DEFINE(typed_ring, typed_element)
+
+void test_circular_buffer_typed(void)
+{
+    typed_ring ring;
+    typed_element input[20];
+    typed_element output[20];
+    static typed_element storage[8];
+
+    for (size_t i = 0; i < 20; i++)
+    {
+        input[i].id = i;
+        for (size_t j = 0; j < 4; j++)
+        {
+            input[i].value[j] = (uint32_t)(i * 4 + j);
+        }
+    }
+
+    // 容量必须为2的幂次
+    TEST_ASSERT_FALSE(typed_ring_init(&ring, 6, CIRCULAR_BUFFER_POLICY_REJECT));
+
+    // 拒绝新数据：容量以元素计，多轮写入读取跨越环绕点
+    TEST_ASSERT_TRUE(typed_ring_init(&ring, 8, CIRCULAR_BUFFER_POLICY_REJECT));
+    TEST_ASSERT_FALSE(typed_ring_pop(&ring, &output[0]));
+    for (size_t round = 0; round < 5; round++)
+    {
+        TEST_ASSERT_EQUAL_size_t(5, typed_ring_push_n(&ring, input + round, 5));
+        TEST_ASSERT_EQUAL_size_t(5, typed_ring_count(&ring));
+        TEST_ASSERT_EQUAL_size_t(0, typed_ring_push_n(&ring, input, 4)); // 剩余3个，全部拒绝
+        TEST_ASSERT_TRUE(typed_ring_pop(&ring, &output[0]));
+        TEST_ASSERT_EQUAL_size_t(4, typed_ring_pop_n(&ring, output + 1, 20));
+        TEST_ASSERT_EQUAL_MEMORY(input + round, output, 5 * sizeof(typed_element));
+    }
+    typed_ring_free(&ring);
+
+    // 截断新数据：写入能容纳的前一部分
+    TEST_ASSERT_TRUE(typed_ring_init_static(&ring, storage, 8, CIRCULAR_BUFFER_POLICY_TRUNCATE));
+    TEST_ASSERT_EQUAL_size_t(6, typed_ring_push_n(&ring, input, 6));
+    TEST_ASSERT_EQUAL_size_t(2, typed_ring_push_n(&ring, input + 6, 5));
+    TEST_ASSERT_EQUAL_size_t(8, typed_ring_pop_n(&ring, output, 20));
+    TEST_ASSERT_EQUAL_MEMORY(input, output, 8 * sizeof(typed_element));
+    TEST_ASSERT_EQUAL_MEMORY(input, storage, sizeof(storage)); // 元素直接存放在调用者的数组中
+    typed_ring_free(&ring);
+
+#if ENABLE_LOCK
+    // 覆盖旧数据：丢弃最早的元素，超过容量时只保留最后8个
+    TEST_ASSERT_TRUE(typed_ring_init(&ring, 8, CIRCULAR_BUFFER_POLICY_OVERWRITE));
+    TEST_ASSERT_EQUAL_size_t(6, typed_ring_push_n(&ring, input, 6));
+    TEST_ASSERT_EQUAL_size_t(4, typed_ring_push_n(&ring, input + 6, 4));
+    TEST_ASSERT_EQUAL_size_t(8, typed_ring_pop_n(&ring, output, 20));
+    TEST_ASSERT_EQUAL_MEMORY(input + 2, output, 8 * sizeof(typed_element));
+    TEST_ASSERT_EQUAL_size_t(8, typed_ring_push_n(&ring, input, 20));
+    TEST_ASSERT_EQUAL_size_t(8, typed_ring_pop_n(&ring, output, 20));
+    TEST_ASSERT_EQUAL_MEMORY(input + 12, output, 8 * sizeof(typed_element));
+    typed_ring_free(&ring);
+#else
+    // 无锁模式下预留不支持覆盖旧数据，初始化直接失败，而不是之后静默丢弃全部元素
+    TEST_ASSERT_FALSE(typed_ring_init(&ring, 8, CIRCULAR_BUFFER_POLICY_OVERWRITE));
+    TEST_ASSERT_FALSE(typed_ring_init_static(&ring, storage, 8, CIRCULAR_BUFFER_POLICY_OVERWRITE));
+#endif
+}
+
+// 测试调用者提供内存的初始化方式：运行时初始化和编译期初始化
+static char static_storage[256];
+static char initializer_storage[64];
+static circular_buffer initializer_ring = CIRCULAR_BUFFER_INITIALIZER(initializer_storage, sizeof(initializer_storage));
+
+void test_circular_buffer_init_static(void)
+{
+    circular_buffer cb;
+    circular_buffer_options options = {.flags = CIRCULAR_BUFFER_FLAG_STATIC_STORAGE};
+    char write_data[48];
+    char read_data[48];
+
+    for (size_t i = 0; i < sizeof(write_data); i++)
+    {
+        write_data[i] = (char)(i * 3);
+    }
+
+    // 无效参数
+    TEST_ASSERT_FALSE(circular_buffer_init_static(&cb, NULL, sizeof(static_storage)));
+    TEST_ASSERT_FALSE(circular_buffer_init_static(&cb, static_storage, 100));
+    TEST_ASSERT_FALSE(circular_buffer_init_ex(&cb, sizeof(static_storage), &options));
+
+    // 运行时初始化：数据直接写入调用者的内存
+    TEST_ASSERT_TRUE(circular_buffer_init_static(&cb, static_storage, sizeof(static_storage)));
+    TEST_ASSERT_EQUAL_PTR(static_storage, cb.buffer);
+    TEST_ASSERT_TRUE(circular_buffer_write(&cb, write_data, sizeof(write_data)));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(write_data, static_storage, sizeof(write_data));
+    TEST_ASSERT_TRUE(circular_buffer_read(&cb, read_data, sizeof(read_data)));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(write_data, read_data, sizeof(read_data));
+    circular_buffer_free(&cb); // 不释放static_storage
+    TEST_ASSERT_NULL(cb.buffer);
+
+    // 编译期初始化：无需任何初始化调用即可使用，包括等待接口
+    TEST_ASSERT_EQUAL_size_t(sizeof(initializer_storage), initializer_ring.size);
+    TEST_ASSERT_TRUE(circular_buffer_is_empty(&initializer_ring));
+    TEST_ASSERT_FALSE(circular_buffer_read_timed(&initializer_ring, read_data, 1, 10));
+    for (int round = 0; round < 3; round++) // 多轮写入读取，跨越环绕点
+    {
+        TEST_ASSERT_TRUE(circular_buffer_write_timed(&initializer_ring, write_data, sizeof(write_data), 10));
+        TEST_ASSERT_FALSE(circular_buffer_write(&initializer_ring, write_data, sizeof(write_data)));
+        TEST_ASSERT_TRUE(circular_buffer_read(&initializer_ring, read_data, sizeof(read_data)));
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(write_data, read_data, sizeof(read_data));
+    }
+    circular_buffer_free(&initializer_ring);
+}
+
+// 测试大页和NUMA放置提示：提示不可用时逐级回退，初始化总能成功
+void test_circular_buffer_large_memory(void)
+{
+    circular_buffer cb;
+    circular_buffer_options options = {
+        .flags = CIRCULAR_BUFFER_FLAG_HUGE_PAGES | CIRCULAR_BUFFER_FLAG_NUMA_BIND,
+        .numa_node = 0,
+    };
+    size_t buffer_size = 4u * 1024u * 1024u;
+    char write_data[4096];
+    char read_data[4096];
+
+    for (size_t i = 0; i < sizeof(write_data); i++)
+    {
+        write_data[i] = (char)(i * 5);
+    }
+
+    // 显式大页通常没有预留，应回退到透明大页或普通页；flags中只保留实际生效的提示
+    TEST_ASSERT_TRUE(circular_buffer_init_ex(&cb, buffer_size, &options));
+    TEST_ASSERT_EQUAL_UINT(0, cb.flags & ~(options.flags | CIRCULAR_BUFFER_FLAG_TRANSPARENT_HUGE_PAGES));
+    for (size_t written = 0; written < 2 * buffer_size; written += sizeof(write_data))
+    {
+        TEST_ASSERT_TRUE(circular_buffer_write(&cb, write_data, sizeof(write_data)));
+        TEST_ASSERT_TRUE(circular_buffer_read(&cb, read_data, sizeof(read_data)));
+    }
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(write_data, read_data, sizeof(read_data));
+    circular_buffer_free(&cb);
+
+    // 不存在的节点和交错分布同样不会导致初始化失败
+    options.flags = CIRCULAR_BUFFER_FLAG_NUMA_BIND;
+    options.numa_node = 100000;
+    TEST_ASSERT_TRUE(circular_buffer_init_ex(&cb, 4096, &options));
+    TEST_ASSERT_EQUAL_UINT(0, cb.flags);
+    circular_buffer_free(&cb);
+    options.flags = CIRCULAR_BUFFER_FLAG_TRANSPARENT_HUGE_PAGES | CIRCULAR_BUFFER_FLAG_NUMA_INTERLEAVE;
+    TEST_ASSERT_TRUE(circular_buffer_init_ex(&cb, 4096, &options));
+    TEST_ASSERT_TRUE(circular_buffer_write(&cb, write_data, 4096));
+    TEST_ASSERT_TRUE(circular_buffer_read(&cb, read_data, 4096));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(write_data, read_data, 4096);
+    circular_buffer_free(&cb);
+}
+
+// 测试文件描述符直接读写
+void test_circular_buffer_fd(void)
+{
+    circular_buffer cb;
+    int fds[2];
+    char write_data[48];
+    char read_data[48];
+
+    for (size_t i = 0; i < sizeof(write_data); i++)
+    {
+        write_data[i] = (char)(i + 1);
+    }
+    TEST_ASSERT_TRUE(circular_buffer_init(&cb, 32));
+    TEST_ASSERT_EQUAL_INT(0, pipe(fds));
+    TEST_ASSERT_NOT_EQUAL(-1, fcntl(fds[0], F_SETFL, O_NONBLOCK));
+    TEST_ASSERT_NOT_EQUAL(-1, fcntl(fds[1], F_SETFL, O_NONBLOCK));
+
+    // 管道为空：非阻塞读取返回EAGAIN，缓冲区不变；缓冲区为空时没有数据可写出
+    TEST_ASSERT_EQUAL_INT(-1, circular_buffer_fill_from_fd(&cb, fds[0]));
+    TEST_ASSERT_TRUE(errno == EAGAIN || errno == EWOULDBLOCK);
+    TEST_ASSERT_TRUE(circular_buffer_is_empty(&cb));
+    TEST_ASSERT_EQUAL_INT(0, circular_buffer_drain_to_fd(&cb, fds[1]));
+
+    // 先让start/end前进到缓冲区中间，使后续读写都跨越环绕点
+    TEST_ASSERT_TRUE(circular_buffer_write(&cb, write_data, 20));
+    TEST_ASSERT_TRUE(circular_buffer_read(&cb, read_data, 20));
+
+    // 管道中有48字节，一次readv只能填满缓冲区的32字节，剩余16字节留在管道中
+    TEST_ASSERT_EQUAL_INT(48, write(fds[1], write_data, sizeof(write_data)));
+    TEST_ASSERT_EQUAL_INT(32, circular_buffer_fill_from_fd(&cb, fds[0]));
+    TEST_ASSERT_TRUE(circular_buffer_is_full(&cb));
+    TEST_ASSERT_EQUAL_INT(-1, circular_buffer_fill_from_fd(&cb, fds[0]));
+    TEST_ASSERT_EQUAL_INT(ENOBUFS, errno);
+
+    // 取出管道中剩余的16字节，缓冲区中跨越环绕点的两段数据通过一次writev写回管道，顺序不变
+    TEST_ASSERT_EQUAL_INT(16, read(fds[0], read_data, sizeof(read_data)));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(write_data + 32, read_data, 16);
+    TEST_ASSERT_EQUAL_INT(32, circular_buffer_drain_to_fd(&cb, fds[1]));
+    TEST_ASSERT_TRUE(circular_buffer_is_empty(&cb));
+    TEST_ASSERT_EQUAL_INT(32, read(fds[0], read_data, sizeof(read_data)));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(write_data, read_data, 32);
+
+    // 写入端关闭后读取返回0（EOF）
+    close(fds[1]);
+    TEST_ASSERT_EQUAL_INT(0, circular_buffer_fill_from_fd(&cb, fds[0]));
+    TEST_ASSERT_TRUE(circular_buffer_is_empty(&cb));
+    close(fds[0]);
+    circular_buffer_free(&cb);
+
+#if !ENABLE_LOCK
+    // 无锁覆盖模式下写入端可能在writev期间套圈，写出被改写的数据，不支持
+    circular_buffer_options options = {.policy = CIRCULAR_BUFFER_POLICY_OVERWRITE};
+    TEST_ASSERT_TRUE(circular_buffer_init_ex(&cb, 32, &options));
+    TEST_ASSERT_TRUE(circular_buffer_write(&cb, write_data, 16));
+    TEST_ASSERT_EQUAL_INT(-1, circular_buffer_drain_to_fd(&cb, STDOUT_FILENO));
+    TEST_ASSERT_EQUAL_INT(ENOTSUP, errno);
+    TEST_ASSERT_EQUAL_size_t(16, circular_buffer_length(&cb));
+    circular_buffer_free(&cb);
+#endif
+}
+
+/**
+ * @brief 建立一对本地回环TCP连接
+ *
+ * @param fds 输出，[0]为发送端，[1]为接收端
+ * @return 成功返回true
+ */
+static bool tcp_loopback_pair(int fds[2])
+{
+    struct sockaddr_in addr = {.sin_family = AF_INET, .sin_addr.s_addr = htonl(INADDR_LOOPBACK)};
+    socklen_t length = sizeof(addr);
+    int listener = socket(AF_INET, SOCK_STREAM, 0);
+    bool ok = listener >= 0 && bind(listener, (struct sockaddr *)&addr, sizeof(addr)) == 0 &&
+              listen(listener, 1) == 0 && getsockname(listener, (struct sockaddr *)&addr, &length) == 0;
+    fds[0] = ok ? socket(AF_INET, SOCK_STREAM, 0) : -1;
+    ok = ok && fds[0] >= 0 && connect(fds[0], (struct sockaddr *)&addr, sizeof(addr)) == 0;
+    fds[1] = ok ? accept(listener, NULL, NULL) : -1;
+    if (listener >= 0)
+    {
+        close(listener);
+    }
+    return ok && fds[1] >= 0;
+}
+
+// 测试vmsplice/splice与MSG_ZEROCOPY发送器：数据在内核释放页面之前保持借出
+void test_circular_buffer_splice(void)
+{
+    circular_buffer cb;
+    circular_buffer_splicer splicer;
+    int tcp[2];
+    int sv[2];
+    int fds[2];
+    static char write_data[12000];
+    static char read_data[12000];
+
+    for (size_t i = 0; i < sizeof(write_data); i++)
+    {
+        write_data[i] = (char)(i * 7 + 3);
+    }
+    TEST_ASSERT_TRUE(circular_buffer_init(&cb, 16384));
+
+    // 管道和Unix域套接字的读取端可以把页面继续splice到别处，无法判断何时归还，不支持
+    TEST_ASSERT_EQUAL_INT(0, pipe(fds));
+    TEST_ASSERT_FALSE(circular_buffer_splicer_init(&splicer, &cb, fds[1]));
+    TEST_ASSERT_EQUAL_INT(0, socketpair(AF_UNIX, SOCK_STREAM, 0, sv));
+    TEST_ASSERT_FALSE(circular_buffer_splicer_init(&splicer, &cb, sv[0]));
+
+    // 套接字：以MSG_ZEROCOPY发送，收到完成通知之前数据仍然借给内核；第二轮跨越环绕点
+    TEST_ASSERT_TRUE(tcp_loopback_pair(tcp));
+    TEST_ASSERT_TRUE(circular_buffer_splicer_init(&splicer, &cb, tcp[0]));
+    TEST_ASSERT_EQUAL_INT(0, circular_buffer_splicer_send(&splicer));
+    for (int round = 0; round < 2; round++)
+    {
+        TEST_ASSERT_TRUE(circular_buffer_write(&cb, write_data, sizeof(write_data)));
+        for (size_t sent = 0; sent < sizeof(write_data);)
+        {
+            ssize_t n = circular_buffer_splicer_send(&splicer);
+            TEST_ASSERT_TRUE(n > 0 || (n < 0 && errno == EAGAIN));
+            sent += (n > 0) ? (size_t)n : 0;
+        }
+        TEST_ASSERT_TRUE(splicer.lent > 0);
+        for (size_t received = 0; received < sizeof(read_data);)
+        {
+            ssize_t n = read(tcp[1], read_data + received, sizeof(read_data) - received);
+            TEST_ASSERT_TRUE(n > 0);
+            received += (size_t)n;
+        }
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(write_data, read_data, sizeof(read_data));
+        // 完成通知异步到达，全部归还后缓冲区为空
+        for (int wait = 0; wait < 1000 && splicer.lent > 0; wait++)
+        {
+            if (circular_buffer_splicer_reclaim(&splicer) == 0)
+            {
+                nanosleep(&(struct timespec){.tv_nsec = 1000000}, NULL);
+            }
+        }
+        TEST_ASSERT_EQUAL_UINT(0, splicer.lent);
+        TEST_ASSERT_TRUE(circular_buffer_is_empty(&cb));
+    }
+    circular_buffer_splicer_free(&splicer);
+
+    // 普通文件：splice返回时数据已经拷贝到页缓存，离开内部管道即可归还
+    FILE *file = tmpfile();
+    TEST_ASSERT_NOT_NULL(file);
+    TEST_ASSERT_TRUE(circular_buffer_splicer_init(&splicer, &cb, fileno(file)));
+    TEST_ASSERT_TRUE(circular_buffer_write(&cb, write_data, sizeof(write_data)));
+    TEST_ASSERT_EQUAL_INT((int)sizeof(write_data), circular_buffer_splicer_send(&splicer));
+    TEST_ASSERT_EQUAL_UINT(sizeof(write_data), circular_buffer_splicer_reclaim(&splicer));
+    TEST_ASSERT_TRUE(circular_buffer_is_empty(&cb));
+    TEST_ASSERT_EQUAL_INT(0, circular_buffer_splicer_send(&splicer)); // 没有新数据
+    TEST_ASSERT_EQUAL_INT((int)sizeof(read_data), pread(fileno(file), read_data, sizeof(read_data), 0));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(write_data, read_data, sizeof(read_data));
+    circular_buffer_splicer_free(&splicer);
+    fclose(file);
+
+    circular_buffer_free(&cb);
+    close(fds[0]);
+    close(fds[1]);
+    close(sv[0]);
+    close(sv[1]);
+    close(tcp[0]);
+    close(tcp[1]);
+
+    // 覆盖旧数据策略会改写借出的页面，不支持
+    circular_buffer_options options = {.policy = CIRCULAR_BUFFER_POLICY_OVERWRITE};
+    TEST_ASSERT_TRUE(circular_buffer_init_ex(&cb, 4096, &options));
+    TEST_ASSERT_FALSE(circular_buffer_splicer_init(&splicer, &cb, STDOUT_FILENO));
+    circular_buffer_free(&cb);
+}
+
+// 测试io_uring批量读写引擎，io_uring不可用时两轮都走readv/writev回退
+void test_circular_buffer_uring(void)
+{
+    unsigned int modes[] = {0, CIRCULAR_BUFFER_URING_FLAG_FALLBACK};
+    char write_data[4096];
+    char read_data[4096];
+
+    for (size_t i = 0; i < sizeof(write_data); i++)
+    {
+        write_data[i] = (char)(i * 13 + 1);
+    }
+    for (size_t m = 0; m < sizeof(modes) / sizeof(modes[0]); m++)
+    {
+        circular_buffer_uring engine;
+        circular_buffer cb;
+        int sv[2];
+        int fds[2];
+
+        TEST_ASSERT_TRUE(circular_buffer_uring_init(&engine, 4, modes[m]));
+        TEST_ASSERT_TRUE(circular_buffer_init(&cb, 4096));
+        TEST_ASSERT_EQUAL_INT(0, socketpair(AF_UNIX, SOCK_STREAM, 0, sv));
+        TEST_ASSERT_EQUAL_INT(0, pipe(fds));
+        TEST_ASSERT_NOT_EQUAL(-1, fcntl(fds[0], F_SETFL, O_NONBLOCK)); // 测试线程读取管道时不阻塞
+
+        // 先让索引前进到缓冲区中间，读写区域都跨越环绕点
+        TEST_ASSERT_TRUE(circular_buffer_write(&cb, write_data, 3000));
+        TEST_ASSERT_TRUE(circular_buffer_read(&cb, read_data, 3000));
+
+        // 代理：从套接字读入缓冲区，再从缓冲区写入管道
+        int in = circular_buffer_uring_add(&engine, &cb, sv[1], CIRCULAR_BUFFER_URING_FILL);
+        int out = circular_buffer_uring_add(&engine, &cb, fds[1], CIRCULAR_BUFFER_URING_DRAIN);
+        TEST_ASSERT_TRUE(in >= 0 && out >= 0);
+        TEST_ASSERT_EQUAL_INT((int)sizeof(write_data), write(sv[0], write_data, sizeof(write_data)));
+
+        size_t received = 0;
+        for (int round = 0; round < 100 && received < sizeof(read_data); round++)
+        {
+            TEST_ASSERT_TRUE(circular_buffer_uring_submit(&engine) >= 0);
+            TEST_ASSERT_TRUE(circular_buffer_uring_reap(&engine, 1) >= 0);
+            ssize_t n = read(fds[0], read_data + received, sizeof(read_data) - received);
+            if (n > 0)
+            {
+                received += (size_t)n;
+            }
+        }
+        TEST_ASSERT_EQUAL_UINT(sizeof(read_data), received);
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(write_data, read_data, sizeof(read_data));
+
+        // 对端关闭后FILL连接以0（EOF）完成，不再提交
+        close(sv[0]);
+        for (int round = 0; round < 100 && !engine.conns[in].closed; round++)
+        {
+            circular_buffer_uring_submit(&engine);
+            circular_buffer_uring_reap(&engine, 1);
+        }
+        TEST_ASSERT_TRUE(engine.conns[in].closed);
+        TEST_ASSERT_EQUAL_INT(0, engine.conns[in].result);
+        TEST_ASSERT_TRUE(circular_buffer_is_empty(&cb));
+        TEST_ASSERT_TRUE(circular_buffer_uring_remove(&engine, in));
+        TEST_ASSERT_TRUE(circular_buffer_uring_remove(&engine, out));
+
+        circular_buffer_uring_free(&engine);
+        circular_buffer_free(&cb);
+        close(sv[1]);
+        close(fds[0]);
+        close(fds[1]);
+    }
+
+    // 共享内存模式下cb->buffer为NULL，固定缓冲区按段内的数据区注册
+    char name[64];
+    snprintf(name, sizeof(name), "/circular_buffer_uring_%d", (int)getpid());
+    circular_buffer_unlink_shared(name);
+    circular_buffer *shared = circular_buffer_create_shared(name, 4096, NULL);
+    TEST_ASSERT_NOT_NULL(shared);
+    circular_buffer_uring engine;
+    TEST_ASSERT_TRUE(circular_buffer_uring_init(&engine, 1, 0));
+    int sv[2];
+    TEST_ASSERT_EQUAL_INT(0, socketpair(AF_UNIX, SOCK_STREAM, 0, sv));
+    int id = circular_buffer_uring_add(&engine, shared, sv[1], CIRCULAR_BUFFER_URING_FILL);
+    TEST_ASSERT_TRUE(id >= 0);
+    if (engine.ring_fd >= 0)
+    {
+        TEST_ASSERT_TRUE(engine.conns[id].fixed);
+    }
+    TEST_ASSERT_EQUAL_INT(4, write(sv[0], "ring", 4));
+    size_t received = 0;
+    for (int round = 0; round < 100 && received < 4; round++)
+    {
+        TEST_ASSERT_TRUE(circular_buffer_uring_submit(&engine) >= 0);
+        TEST_ASSERT_TRUE(circular_buffer_uring_reap(&engine, 1) >= 0);
+        received = circular_buffer_length(shared);
+    }
+    TEST_ASSERT_EQUAL_UINT(4, received);
+    TEST_ASSERT_TRUE(circular_buffer_read(shared, read_data, 4));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY("ring", read_data, 4);
+    close(sv[0]);
+    for (int round = 0; round < 100 && !engine.conns[id].closed; round++)
+    {
+        circular_buffer_uring_submit(&engine);
+        circular_buffer_uring_reap(&engine, 1);
+    }
+    TEST_ASSERT_TRUE(circular_buffer_uring_remove(&engine, id));
+    circular_buffer_uring_free(&engine);
+    close(sv[1]);
+    circular_buffer_detach_shared(shared);
+    TEST_ASSERT_TRUE(circular_buffer_unlink_shared(name));
+}
+
+// 测试跨进程共享的环形缓冲区：子进程在另一个映射地址上写入，持有写入端锁时退出
+void test_circular_buffer_shared(void)
+{
+    char name[64];
+    char write_data[1000];
+    char read_data[1000];
+    circular_buffer_spans spans;
+
+    snprintf(name, sizeof(name), "/circular_buffer_test_%d", (int)getpid());
+    circular_buffer_unlink_shared(name); // 清理上次异常退出留下的段
+    for (size_t i = 0; i < sizeof(write_data); i++)
+    {
+        write_data[i] = (char)(i * 11 + 5);
+    }
+
+    circular_buffer *cb = circular_buffer_create_shared(name, 4096, NULL);
+    TEST_ASSERT_NOT_NULL(cb);
+    TEST_ASSERT_NULL(cb->buffer); // 段内只保存偏移
+    TEST_ASSERT_NULL(circular_buffer_create_shared(name, 4096, NULL)); // 同名的段已存在
+
+    pid_t pid = fork();
+    TEST_ASSERT_TRUE(pid >= 0);
+    if (pid == 0)
+    {
+        // 子进程继承了父进程的映射，attach得到的是另一个地址上的同一个段
+        circular_buffer *child = circular_buffer_attach_shared(name);
+        bool ok = (child != NULL && child != cb);
+        // 共写入10000字节，超过缓冲区大小，需要等待父进程读取并跨进程唤醒
+        for (int i = 0; ok && i < 10; i++)
+        {
+            ok = circular_buffer_write_timed(child, write_data, sizeof(write_data), 5000);
+        }
+        // 预留后不提交直接退出：启用锁时退出时仍持有写入端的锁
+        ok = ok && circular_buffer_write_reserve(child, 16, &spans);
+        _exit(ok ? 0 : 1);
+    }
+
+    for (int i = 0; i < 10; i++)
+    {
+        TEST_ASSERT_TRUE(circular_buffer_read_timed(cb, read_data, sizeof(read_data), 5000));
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(write_data, read_data, sizeof(read_data));
+    }
+    int status = 0;
+    TEST_ASSERT_EQUAL_INT(pid, waitpid(pid, &status, 0));
+    TEST_ASSERT_TRUE(WIFEXITED(status));
+    TEST_ASSERT_EQUAL_INT(0, WEXITSTATUS(status));
+
+    // 健壮锁被接管，未提交的预留不可见，写入和读取照常进行
+    TEST_ASSERT_TRUE(circular_buffer_is_empty(cb));
+    TEST_ASSERT_TRUE(circular_buffer_write(cb, write_data, 16));
+    TEST_ASSERT_TRUE(circular_buffer_read(cb, read_data, 16));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(write_data, read_data, 16);
+
+    circular_buffer_detach_shared(cb);
+    TEST_ASSERT_TRUE(circular_buffer_unlink_shared(name));
+    TEST_ASSERT_NULL(circular_buffer_attach_shared(name));
+}
+
+// 测试以文件为存储的持久化环形缓冲区
+void test_circular_buffer_persistent(void)
+{
+    char path[64];
+    char write_data[1500];
+    char read_data[3600];
+    circular_buffer_spans spans;
+    circular_buffer_persistent p;
+    circular_buffer_persistent other;
+    circular_buffer_persist_policy policy = {.sync_bytes = 256};
+
+    snprintf(path, sizeof(path), "/tmp/circular_buffer_test_%d.ring", (int)getpid());
+    unlink(path); // 清理上次异常退出留下的文件
+    for (size_t i = 0; i < sizeof(write_data); i++)
+    {
+        write_data[i] = (char)(i * 13 + 3);
+    }
+
+    // 新建文件，写入后读走一部分，再写入跨越缓冲区末尾
+    TEST_ASSERT_TRUE(circular_buffer_open_persistent(&p, path, 4096, NULL, &policy));
+    TEST_ASSERT_NULL(p.cb->buffer); // 文件中只保存偏移
+    TEST_ASSERT_TRUE(circular_buffer_write_persistent(&p, write_data, 1000));
+    TEST_ASSERT_TRUE(circular_buffer_write_persistent(&p, write_data, 1500));
+    TEST_ASSERT_TRUE(circular_buffer_read(p.cb, read_data, 1000));
+    TEST_ASSERT_TRUE(circular_buffer_write_persistent(&p, write_data, 1500));
+    TEST_ASSERT_TRUE(circular_buffer_write_persistent(&p, write_data, 1000));
+    // 每次写入都超过sync_bytes，写入后立即同步
+    TEST_ASSERT_EQUAL_size_t(atomic_load(&p.cb->end), p.synced_end);
+    // 未达到sync_bytes且没有时间策略时不同步，显式同步后追上
+    TEST_ASSERT_TRUE(circular_buffer_read(p.cb, read_data, 600));
+    TEST_ASSERT_TRUE(circular_buffer_write_persistent(&p, write_data, 100));
+    TEST_ASSERT_EQUAL_size_t(atomic_load(&p.cb->end) - 100, p.synced_end);
+    TEST_ASSERT_TRUE(circular_buffer_sync_persistent(&p));
+    TEST_ASSERT_EQUAL_size_t(atomic_load(&p.cb->end), p.synced_end);
+    // 同一文件同时只能打开一次
+    TEST_ASSERT_FALSE(circular_buffer_open_persistent(&other, path, 4096, NULL, NULL));
+    TEST_ASSERT_TRUE(circular_buffer_close_persistent(&p));
+
+    pid_t pid = fork();
+    TEST_ASSERT_TRUE(pid >= 0);
+    if (pid == 0)
+    {
+        // 子进程重新打开后追加数据，预留后不提交、不关闭直接退出，模拟崩溃
+        bool ok = circular_buffer_open_persistent(&p, path, 4096, NULL, NULL);
+        ok = ok && circular_buffer_length(p.cb) == 3500;
+        ok = ok && circular_buffer_write(p.cb, write_data, 100);
+        ok = ok && circular_buffer_write_reserve(p.cb, 64, &spans);
+        _exit(ok ? 0 : 1);
+    }
+    int status = 0;
+    TEST_ASSERT_EQUAL_INT(pid, waitpid(pid, &status, 0));
+    TEST_ASSERT_TRUE(WIFEXITED(status));
+    TEST_ASSERT_EQUAL_INT(0, WEXITSTATUS(status));
+
+    // 大小不一致时失败，不改动文件
+    TEST_ASSERT_FALSE(circular_buffer_open_persistent(&p, path, 8192, NULL, NULL));
+    // 重新打开后内容完整，崩溃时持有的锁和未提交的预留都被重置
+    TEST_ASSERT_TRUE(circular_buffer_open_persistent(&p, path, 4096, NULL, NULL));
+    TEST_ASSERT_EQUAL_size_t(3600, circular_buffer_length(p.cb));
+    TEST_ASSERT_TRUE(circular_buffer_read(p.cb, read_data, 3600));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(write_data + 600, read_data, 900);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(write_data, read_data + 900, 1500);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(write_data, read_data + 2400, 1000);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(write_data, read_data + 3400, 100);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(write_data, read_data + 3500, 100);
+    TEST_ASSERT_TRUE(circular_buffer_write(p.cb, write_data, 16));
+    TEST_ASSERT_TRUE(circular_buffer_read(p.cb, read_data, 16));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(write_data, read_data, 16);
+    TEST_ASSERT_TRUE(circular_buffer_close_persistent(&p));
+
+    unlink(path);
+}
+
+// 测试镜像映射分配方式
+void test_circular_buffer_mirror(void)
+{
+    circular_buffer cb;
+    circular_buffer_options options = {.flags = CIRCULAR_BUFFER_FLAG_MIRROR};
+    size_t buffer_size = 4096;
+    char scratch[4096];
+    char write_data[1024];
+    char read_data[1024];
+    circular_buffer_spans spans;
+
+    // 大小不是页大小整数倍时初始化失败
+    TEST_ASSERT_FALSE(circular_buffer_init_ex(&cb, 16, &options));
+
+    TEST_ASSERT_TRUE(circular_buffer_init_ex(&cb, buffer_size, &options));
+
+    // 移动读写位置，使下一次写入跨越环绕点
+    TEST_ASSERT_TRUE(circular_buffer_write(&cb, scratch, 3500));
+    TEST_ASSERT_TRUE(circular_buffer_read(&cb, scratch, 3500));
+
+    for (size_t i = 0; i < sizeof(write_data); i++)
+    {
+        write_data[i] = (char)(i * 7);
+    }
+    TEST_ASSERT_TRUE(circular_buffer_write(&cb, write_data, sizeof(write_data)));
+
+    // 镜像后半部分与前半部分是同一块内存
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(cb.buffer + buffer_size, cb.buffer, buffer_size);
+
+    // 跨越环绕点的可读区域只有一段连续内存
+    TEST_ASSERT_EQUAL_size_t(sizeof(write_data), circular_buffer_peek_spans(&cb, &spans));
+    TEST_ASSERT_EQUAL_size_t(1, spans.count);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(write_data, spans.span[0].data, sizeof(write_data));
+    TEST_ASSERT_TRUE(circular_buffer_consume(&cb, 0));
+
+    TEST_ASSERT_TRUE(circular_buffer_read(&cb, read_data, sizeof(read_data)));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(write_data, read_data, sizeof(read_data));
+
+    circular_buffer_free(&cb);
+}
+
+// 单生产者单消费者顺序测试：写入递增序列，读取端逐字节校验
+#define SPSC_TOTAL_BYTES (1024 * 1024)
+
+void *spsc_writer_thread(void *arg)
+{
+    circular_buffer *cb = (circular_buffer *)arg;
+    char write_data[64];
+    size_t sent = 0;
+
+    while (sent < SPSC_TOTAL_BYTES)
+    {
+        size_t length = (sent % sizeof(write_data)) + 1;
+        if (length > SPSC_TOTAL_BYTES - sent)
+        {
+            length = SPSC_TOTAL_BYTES - sent;
+        }
+        for (size_t j = 0; j < length; j++)
+        {
+            write_data[j] = (char)(sent + j);
+        }
+        // 空间不足时让出CPU后重试，直到写入成功
+        while (!circular_buffer_write(cb, write_data, length))
+        {
+            sched_yield();
+        }
+        sent += length;
+    }
+    return NULL;
+}
+
+void test_circular_buffer_spsc_ordering(void)
+{
+    circular_buffer cb;
+    size_t buffer_size = 256;
+    char read_data[32];
+    size_t received = 0;
+    size_t errors = 0;
+
+    TEST_ASSERT_TRUE(circular_buffer_init(&cb, buffer_size));
+
+    pthread_t writer;
+    pthread_create(&writer, NULL, spsc_writer_thread, &cb);
+
+    while (received < SPSC_TOTAL_BYTES)
+    {
+        size_t length = (received % sizeof(read_data)) + 1;
+        if (length > SPSC_TOTAL_BYTES - received)
+        {
+            length = SPSC_TOTAL_BYTES - received;
+        }
+        if (!circular_buffer_read(&cb, read_data, length))
+        {
+            sched_yield(); // 数据不足时让出CPU后重试
+            continue;
+        }
+        for (size_t j = 0; j < length; j++)
+        {
+            if (read_data[j] != (char)(received + j))
+            {
+                errors++;
+            }
+        }
+        received += length;
+    }
+
+    pthread_join(writer, NULL);
+    TEST_ASSERT_EQUAL_size_t(0, errors);
+    TEST_ASSERT_TRUE(circular_buffer_is_empty(&cb));
+
+    circular_buffer_free(&cb);
+}
+
+// 状态查询并发测试：读写端并发推进时，不加锁的状态查询结果始终在合法范围内
+static atomic_bool status_done;
+static size_t status_violations;
+
+void *status_monitor_thread(void *arg)
+{
+    circular_buffer *cb = (circular_buffer *)arg;
+    while (!atomic_load(&status_done))
+    {
+        size_t length = circular_buffer_length(cb);
+        if (length > cb->size)
+        {
+            status_violations++;
+        }
+        // 两次查询之间状态可能变化，只检查单次查询自身的结果
+        (void)circular_buffer_is_empty(cb);
+        (void)circular_buffer_is_full(cb);
+        sched_yield();
+    }
+    return NULL;
+}
+
+void test_circular_buffer_status_concurrent(void)
+{
+    circular_buffer cb;
+    char read_data[32];
+    size_t received = 0;
+
+    TEST_ASSERT_TRUE(circular_buffer_init(&cb, 256));
+    atomic_store(&status_done, false);
+    status_violations = 0;
+
+    pthread_t writer, monitor;
+    pthread_create(&writer, NULL, spsc_writer_thread, &cb);
+    pthread_create(&monitor, NULL, status_monitor_thread, &cb);
+
+    while (received < SPSC_TOTAL_BYTES)
+    {
+        received += circular_buffer_read_some(&cb, read_data, sizeof(read_data));
+    }
+
+    pthread_join(writer, NULL);
+    atomic_store(&status_done, true);
+    pthread_join(monitor, NULL);
+    TEST_ASSERT_EQUAL_size_t(0, status_violations);
+    TEST_ASSERT_EQUAL_size_t(0, circular_buffer_length(&cb));
+    TEST_ASSERT_TRUE(circular_buffer_is_empty(&cb));
+    TEST_ASSERT_FALSE(circular_buffer_is_full(&cb));
+
+    circular_buffer_free(&cb);
+}
+
+// 多生产者单消费者测试：多个生产者并发写入定长记录，读取端校验每条记录完整且各生产者内部有序
+#define MPSC_PRODUCERS      4
+#define MPSC_RECORDS        20000
+#define MPSC_RECORD_SIZE    16
+
+void *mpsc_writer_thread(void *arg)
+{
+    circular_buffer *cb = ((void **)arg)[0];
+    unsigned char id = (unsigned char)(size_t)((void **)arg)[1];
+    char record[MPSC_RECORD_SIZE];
+
+    for (unsigned int seq = 0; seq < MPSC_RECORDS; seq++)
+    {
+        // 记录格式：[生产者编号][序号(4字节)][由编号和序号生成的填充字节]
+        record[0] = (char)id;
+        memcpy(record + 1, &seq, sizeof(seq));
+        for (size_t j = 1 + sizeof(seq); j < sizeof(record); j++)
+        {
+            record[j] = (char)(id + seq + j);
+        }
+        // 一半生产者使用等待接口，另一半空间不足时让出CPU后重试
+        if (id & 1)
+        {
+            circular_buffer_write_timed(cb, record, sizeof(record), CIRCULAR_BUFFER_WAIT_FOREVER);
+        }
+        else
+        {
+            while (!circular_buffer_write(cb, record, sizeof(record)))
+            {
+                sched_yield();
+            }
+        }
+    }
+    return NULL;
+}
+
+void test_circular_buffer_mpsc(void)
+{
+    circular_buffer cb;
+    circular_buffer_options options = {.flags = CIRCULAR_BUFFER_FLAG_MULTI_PRODUCER};
+    circular_buffer_spans spans;
+    pthread_t writers[MPSC_PRODUCERS];
+    void *args[MPSC_PRODUCERS][2];
+    unsigned int next_seq[MPSC_PRODUCERS] = {0};
+    char record[MPSC_RECORD_SIZE];
+    size_t errors = 0;
+
+    TEST_ASSERT_TRUE(circular_buffer_init_ex(&cb, 1024, &options));
+    // 多生产者模式下不支持预留写入
+    TEST_ASSERT_FALSE(circular_buffer_write_reserve(&cb, 16, &spans));
+
+    for (size_t i = 0; i < MPSC_PRODUCERS; i++)
+    {
+        args[i][0] = &cb;
+        args[i][1] = (void *)i;
+        pthread_create(&writers[i], NULL, mpsc_writer_thread, args[i]);
+    }
+
+    for (size_t n = 0; n < (size_t)MPSC_PRODUCERS * MPSC_RECORDS; n++)
+    {
+        TEST_ASSERT_TRUE(circular_buffer_read_timed(&cb, record, sizeof(record), CIRCULAR_BUFFER_WAIT_FOREVER));
+        unsigned char id = (unsigned char)record[0];
+        unsigned int seq;
+        memcpy(&seq, record + 1, sizeof(seq));
+        if (id >= MPSC_PRODUCERS || seq != next_seq[id])
+        {
+            errors++;
+            continue;
+        }
+        for (size_t j = 1 + sizeof(seq); j < sizeof(record); j++)
+        {
+            if (record[j] != (char)(id + seq + j))
+            {
+                errors++;
+            }
+        }
+        next_seq[id]++;
+    }
+
+    for (size_t i = 0; i < MPSC_PRODUCERS; i++)
+    {
+        pthread_join(writers[i], NULL);
+    }
+    TEST_ASSERT_EQUAL_size_t(0, errors);
+    TEST_ASSERT_TRUE(circular_buffer_is_empty(&cb));
+
+    // 部分写入：剩余空间不足时只认领能容纳的部分
+    char fill[1024] = {0};
+    TEST_ASSERT_EQUAL_size_t(1000, circular_buffer_write_some(&cb, fill, 1000));
+    TEST_ASSERT_EQUAL_size_t(24, circular_buffer_write_some(&cb, fill, 100));
+    TEST_ASSERT_TRUE(circular_buffer_is_full(&cb));
+
+    circular_buffer_free(&cb);
+}
+
+// 多生产者多消费者队列测试：单线程先进先出与满/空判断，多线程下每个元素恰好出队一次
+#define MPMC_THREADS  4
+#define MPMC_ELEMENTS 50000
+
+static circular_buffer_mpmc mpmc_queue;
+static atomic_size_t mpmc_dequeued;
+static atomic_size_t mpmc_sum;
+
+void *mpmc_producer_thread(void *arg)
+{
+    size_t base = (size_t)arg * MPMC_ELEMENTS;
+    for (size_t i = 0; i < MPMC_ELEMENTS; i++)
+    {
+        size_t value = base + i;
+        while (!circular_buffer_mpmc_enqueue(&mpmc_queue, &value))
+        {
+            sched_yield(); // 队列已满时让出CPU后重试
+        }
+    }
+    return NULL;
+}
+
+void *mpmc_consumer_thread(void *arg)
+{
+    (void)arg;
+    size_t value;
+    while (atomic_load(&mpmc_dequeued) < (size_t)MPMC_THREADS * MPMC_ELEMENTS)
+    {
+        if (!circular_buffer_mpmc_dequeue(&mpmc_queue, &value))
+        {
+            sched_yield(); // 队列为空时让出CPU后重试
+            continue;
+        }
+        atomic_fetch_add(&mpmc_sum, value);
+        atomic_fetch_add(&mpmc_dequeued, 1);
+    }
+    return NULL;
+}
+
+void test_circular_buffer_mpmc(void)
+{
+    circular_buffer_mpmc q;
+    char element[3];
+
+    // 容量必须为不小于2的2的幂次，元素大小不能为0
+    TEST_ASSERT_FALSE(circular_buffer_mpmc_init(&q, 1, sizeof(element)));
+    TEST_ASSERT_FALSE(circular_buffer_mpmc_init(&q, 6, sizeof(element)));
+    TEST_ASSERT_FALSE(circular_buffer_mpmc_init(&q, 8, 0));
+    TEST_ASSERT_FALSE(circular_buffer_mpmc_init(&q, (SIZE_MAX >> 3) + 1, sizeof(element))); // 总大小溢出
+    TEST_ASSERT_FALSE(circular_buffer_mpmc_init(&q, 8, SIZE_MAX));                          // 槽位大小溢出
+
+    // 单线程：按入队顺序出队，满时入队失败，空时出队失败，多次绕圈后依然正确
+    TEST_ASSERT_TRUE(circular_buffer_mpmc_init(&q, 4, sizeof(element)));
+    TEST_ASSERT_FALSE(circular_buffer_mpmc_dequeue(&q, element));
+    for (int round = 0; round < 3; round++)
+    {
+        for (char i = 0; i < 4; i++)
+        {
+            char in[3] = {(char)round, i, (char)(round + i)};
+            TEST_ASSERT_TRUE(circular_buffer_mpmc_enqueue(&q, in));
+        }
+        TEST_ASSERT_FALSE(circular_buffer_mpmc_enqueue(&q, element));
+        for (char i = 0; i < 4; i++)
+        {
+            char expected[3] = {(char)round, i, (char)(round + i)};
+            TEST_ASSERT_TRUE(circular_buffer_mpmc_dequeue(&q, element));
+            TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, element, sizeof(element));
+        }
+        TEST_ASSERT_FALSE(circular_buffer_mpmc_dequeue(&q, element));
+    }
+    circular_buffer_mpmc_free(&q);
+
+    // 多线程：所有元素之和与数量都必须与入队一致
+    pthread_t producers[MPMC_THREADS];
+    pthread_t consumers[MPMC_THREADS];
+    size_t total = (size_t)MPMC_THREADS * MPMC_ELEMENTS;
+    atomic_store(&mpmc_dequeued, 0);
+    atomic_store(&mpmc_sum, 0);
+    TEST_ASSERT_TRUE(circular_buffer_mpmc_init(&mpmc_queue, 64, sizeof(size_t)));
+    for (size_t i = 0; i < MPMC_THREADS; i++)
+    {
+        pthread_create(&producers[i], NULL, mpmc_producer_thread, (void *)i);
+        pthread_create(&consumers[i], NULL, mpmc_consumer_thread, NULL);
+    }
+    for (size_t i = 0; i < MPMC_THREADS; i++)
+    {
+        pthread_join(producers[i], NULL);
+        pthread_join(consumers[i], NULL);
+    }
+    TEST_ASSERT_EQUAL_size_t(total, atomic_load(&mpmc_dequeued));
+    TEST_ASSERT_EQUAL_size_t(total * (total - 1) / 2, atomic_load(&mpmc_sum));
+    size_t value;
+    TEST_ASSERT_FALSE(circular_buffer_mpmc_dequeue(&mpmc_queue, &value));
+    circular_buffer_mpmc_free(&mpmc_queue);
+}
+
 // 主函数运行所有测试
 int main(void)
 {
@@ -311,7 +1663,27 @@ int main(void)
     RUN_TEST(test_circular_buffer_boundary);
     RUN_TEST(test_circular_buffer_random_operations);
     RUN_TEST(test_circular_buffer_stress_test);
+    RUN_TEST(test_circular_buffer_write_read_some);
+    RUN_TEST(test_circular_buffer_timed);
+    RUN_TEST(test_circular_buffer_policy);
+    RUN_TEST(test_circular_buffer_overwrite_concurrent);
+    RUN_TEST(test_circular_buffer_write_reserve_commit);
+    RUN_TEST(test_circular_buffer_peek_consume);
+    RUN_TEST(test_circular_buffer_msg);
+    RUN_TEST(test_circular_buffer_typed);
+    RUN_TEST(test_circular_buffer_init_static);
+    RUN_TEST(test_circular_buffer_large_memory);
+    RUN_TEST(test_circular_buffer_fd);
+    RUN_TEST(test_circular_buffer_splice);
+    RUN_TEST(test_circular_buffer_uring);
+    RUN_TEST(test_circular_buffer_shared);
+    RUN_TEST(test_circular_buffer_persistent);
+    RUN_TEST(test_circular_buffer_mirror);
     RUN_TEST(test_circular_buffer_concurrent);
+    RUN_TEST(test_circular_buffer_spsc_ordering);
+    RUN_TEST(test_circular_buffer_status_concurrent);
+    RUN_TEST(test_circular_buffer_mpsc);
+    RUN_TEST(test_circular_buffer_mpmc);
 
     return UNITY_END(); // 结束Unity测试框架
 }